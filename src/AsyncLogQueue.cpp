@@ -0,0 +1,111 @@
+#include "AsyncLogQueue.hpp"
+
+#include <cstring>
+#include <format>
+
+#include <openvr_driver.h>
+
+SlimeVRDriver::AsyncLogQueue::AsyncLogQueue(std::function<void(const char*)> sink)
+    : sink_(sink)
+    , slots_(std::make_unique<Slot[]>(kCapacity)) {
+    for (size_t i = 0; i < kCapacity; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+SlimeVRDriver::AsyncLogQueue::~AsyncLogQueue() {
+    Stop();
+}
+
+void SlimeVRDriver::AsyncLogQueue::Start() {
+    if (thread_)
+        return;
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&AsyncLogQueue::RunThread, this);
+}
+
+void SlimeVRDriver::AsyncLogQueue::Stop() {
+    if (!thread_)
+        return;
+    running_ = false;
+    // moves the push position so a writer blocked on it wakes up, a full queue means it isn't blocked
+    TryPush("");
+    thread_->join();
+    thread_.reset();
+}
+
+bool SlimeVRDriver::AsyncLogQueue::Push(const char* message) {
+    if (TryPush(message))
+        return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool SlimeVRDriver::AsyncLogQueue::TryPush(const char* message) {
+    uint64_t position = push_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots_[position % kCapacity];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            // the slot is free, claim it unless another producer was faster
+            if (push_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (sequence < position) {
+            // the slot still holds the message from one lap ago, the queue is full
+            return false;
+        } else {
+            position = push_position_.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t length = strnlen(message, kMaxMessageLength);
+    std::memcpy(slot->message, message, length);
+    slot->message[length] = '\0';
+    slot->sequence.store(position + 1, std::memory_order_release);
+    // cheap while the writer isn't blocked
+    push_position_.notify_one();
+    return true;
+}
+
+SlimeVRDriver::AsyncLogQueue& SlimeVRDriver::AsyncLogQueue::ForDriverLog() {
+    static AsyncLogQueue queue([](const char* message) { vr::VRDriverLog()->Log(message); });
+    return queue;
+}
+
+void SlimeVRDriver::AsyncLogQueue::RunThread() {
+    while (running_) {
+        if (Drain())
+            continue;
+        uint64_t position = push_position_.load(std::memory_order_relaxed);
+        if (position == pop_position_) {
+            // empty, sleep until a producer claims a slot
+            push_position_.wait(position, std::memory_order_relaxed);
+        } else {
+            // a producer claimed the next slot but is still copying its message
+            std::this_thread::yield();
+        }
+    }
+    Drain();
+}
+
+size_t SlimeVRDriver::AsyncLogQueue::Drain() {
+    size_t written = 0;
+    while (true) {
+        Slot& slot = slots_[pop_position_ % kCapacity];
+        if (slot.sequence.load(std::memory_order_acquire) != pop_position_ + 1)
+            break;
+        if (slot.message[0] != '\0')
+            sink_(slot.message);
+        slot.sequence.store(pop_position_ + kCapacity, std::memory_order_release);
+        pop_position_++;
+        written++;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped_) {
+        sink_(std::format("{} log messages dropped", dropped - reported_dropped_).c_str());
+        reported_dropped_ = dropped;
+    }
+    return written;
+}
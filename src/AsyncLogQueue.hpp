@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace SlimeVRDriver {
+
+/**
+ * Bounded multi-producer queue of log messages, written to a sink by a background thread.
+ *
+ * Push copies the message into a preallocated slot with a few atomic operations, so logging from the IO and pose
+ * threads never blocks on the sink or allocates. When the queue is full the message is dropped and counted, and the
+ * number of dropped messages is written to the sink once the queue drained.
+ *
+ * The writer thread blocks on the push position while the queue is empty and is woken by the next Push.
+ */
+class AsyncLogQueue {
+public:
+    static constexpr size_t kCapacity = 1024;
+    // longer messages are truncated
+    static constexpr size_t kMaxMessageLength = 511;
+
+    explicit AsyncLogQueue(std::function<void(const char*)> sink);
+    ~AsyncLogQueue();
+
+    /**
+     * Starts the thread writing queued messages to the sink.
+     */
+    void Start();
+
+    /**
+     * Writes the remaining messages and stops the thread. Blocks until it exited.
+     */
+    void Stop();
+
+    bool IsRunning() const {
+        return running_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Queues a message. Safe to call from any thread.
+     *
+     * @param message Null terminated message, truncated to kMaxMessageLength. Empty messages aren't written.
+     * @return False if the queue was full and the message was dropped.
+     */
+    bool Push(const char* message);
+
+    uint64_t GetDroppedCount() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Queue in front of vr::VRDriverLog, started and stopped with the driver.
+     */
+    static AsyncLogQueue& ForDriverLog();
+
+private:
+    struct Slot {
+        // equals the push position the slot is free for, or that position + 1 once it holds a message
+        std::atomic<uint64_t> sequence;
+        char message[kMaxMessageLength + 1];
+    };
+
+    /**
+     * Copies a message into the next free slot and wakes the writer.
+     *
+     * @return False if the queue was full.
+     */
+    bool TryPush(const char* message);
+
+    void RunThread();
+
+    /**
+     * Writes all queued messages to the sink. Only called from one thread at a time.
+     *
+     * @return The number of messages written.
+     */
+    size_t Drain();
+
+    std::function<void(const char*)> sink_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> push_position_ = 0;
+    alignas(64) uint64_t pop_position_ = 0;
+    std::atomic<uint64_t> dropped_ = 0;
+    uint64_t reported_dropped_ = 0;
+    std::atomic<bool> running_ = false;
+    std::unique_ptr<std::thread> thread_ = nullptr;
+};
+
+} // namespace SlimeVRDriver
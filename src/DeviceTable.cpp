@@ -0,0 +1,64 @@
+#include "DeviceTable.hpp"
+
+#include <limits>
+
+namespace {
+
+void SetId(SlimeVRDriver::DeviceTable::Snapshot& snapshot, int id, SlimeVRDriver::IVRDevice* device) {
+    auto entry = std::lower_bound(snapshot.by_id.begin(), snapshot.by_id.end(), id, [](const auto& entry, int id) { return entry.first < id; });
+    if (entry != snapshot.by_id.end() && entry->first == id)
+        entry->second = device;
+    else
+        snapshot.by_id.insert(entry, { id, device });
+}
+
+} // namespace
+
+SlimeVRDriver::DeviceTable::DeviceTable() {
+    Publish(std::make_unique<Snapshot>());
+}
+
+std::vector<std::shared_ptr<SlimeVRDriver::IVRDevice>> SlimeVRDriver::DeviceTable::CopyDevices() {
+    // snapshots are only freed by writers, holding the lock keeps the current one alive
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return current_owner_->devices;
+}
+
+void SlimeVRDriver::DeviceTable::Add(std::shared_ptr<IVRDevice> device) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto snapshot = std::make_unique<Snapshot>(*current_owner_);
+    SetId(*snapshot, device->GetDeviceId(), device.get());
+    snapshot->devices.push_back(std::move(device));
+    Publish(std::move(snapshot));
+}
+
+void SlimeVRDriver::DeviceTable::MapId(int id, IVRDevice* device) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto snapshot = std::make_unique<Snapshot>(*current_owner_);
+    SetId(*snapshot, id, device);
+    Publish(std::move(snapshot));
+}
+
+size_t SlimeVRDriver::DeviceTable::CountRetired() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return retired_.size();
+}
+
+void SlimeVRDriver::DeviceTable::Publish(std::unique_ptr<Snapshot> snapshot) {
+    current_.store(snapshot.get());
+    uint64_t generation = generation_.fetch_add(1) + 1;
+    if (current_owner_)
+        retired_.push_back({ generation, std::move(current_owner_) });
+    current_owner_ = std::move(snapshot);
+    FreeRetired();
+}
+
+void SlimeVRDriver::DeviceTable::FreeRetired() {
+    uint64_t oldest_seen = std::numeric_limits<uint64_t>::max();
+    for (auto& seen : reader_generations_) {
+        uint64_t generation = seen.load();
+        if (generation)
+            oldest_seen = std::min(oldest_seen, generation);
+    }
+    std::erase_if(retired_, [&](const Retired& retired) { return retired.generation <= oldest_seen; });
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <IVRDevice.hpp>
+
+namespace SlimeVRDriver {
+
+/**
+ * Device lookup table shared between the bridge IO thread and SteamVR's frame thread.
+ *
+ * Readers load an immutable snapshot through an atomic pointer and never lock. Writers serialise on a mutex,
+ * copy the current snapshot, modify the copy and publish it (copy-on-write).
+ *
+ * Superseded snapshots are freed once every thread reading the table passed a quiescent point, a place where it holds
+ * no snapshot, with `Quiesce`. Devices themselves are never removed, so device pointers returned by the table stay
+ * valid for the lifetime of the table.
+ */
+class DeviceTable {
+public:
+    /**
+     * Threads that read snapshots, each reports its quiescent points separately.
+     */
+    enum class Reader {
+        FRAME,
+        BRIDGE,
+        POSE_SUBMITTER,
+        COUNT,
+    };
+
+    struct Snapshot {
+        /**
+         * All devices in the order they were added.
+         */
+        std::vector<std::shared_ptr<IVRDevice>> devices;
+
+        /**
+         * Tracker ids and the devices they resolve to, sorted by id.
+         */
+        std::vector<std::pair<int, IVRDevice*>> by_id;
+
+        /**
+         * Looks up a device by tracker id.
+         *
+         * @param id Tracker id.
+         * @return The device, or nullptr if no device has this id.
+         */
+        IVRDevice* FindById(int id) const {
+            auto entry = std::lower_bound(by_id.begin(), by_id.end(), id, [](const auto& entry, int id) { return entry.first < id; });
+            if (entry == by_id.end() || entry->first != id)
+                return nullptr;
+            return entry->second;
+        }
+    };
+
+    DeviceTable();
+    ~DeviceTable() = default;
+
+    DeviceTable(const DeviceTable&) = delete;
+    DeviceTable& operator=(const DeviceTable&) = delete;
+
+    /**
+     * Returns the current snapshot. Wait-free.
+     *
+     * Only call from a reader that passed `Quiesce` and isn't offline. The snapshot stays valid until that reader's
+     * next `Quiesce` or `GoOffline`.
+     *
+     * @return The latest published snapshot.
+     */
+    const Snapshot& Get() const {
+        return *current_.load();
+    }
+
+    /**
+     * Looks up a device by tracker id in the current snapshot. Wait-free, same rules as `Get`.
+     *
+     * @param id Tracker id.
+     * @return The device, or nullptr if no device has this id.
+     */
+    IVRDevice* FindById(int id) const {
+        return Get().FindById(id);
+    }
+
+    /**
+     * Marks a quiescent point of a reader: it doesn't use snapshots it loaded before anymore. Brings the reader online
+     * if it was offline, call it before reading.
+     */
+    void Quiesce(Reader reader) const {
+        auto& seen = reader_generations_[static_cast<size_t>(reader)];
+        uint64_t generation = generation_.load();
+        if (seen.load(std::memory_order_relaxed) != generation)
+            seen.store(generation);
+    }
+
+    /**
+     * Marks a reader as not reading the table until its next `Quiesce`, so it doesn't hold back freeing snapshots.
+     */
+    void GoOffline(Reader reader) const {
+        reader_generations_[static_cast<size_t>(reader)].store(0);
+    }
+
+    /**
+     * Returns a copy of the current device list. Can be called from any thread, not only readers.
+     */
+    std::vector<std::shared_ptr<IVRDevice>> CopyDevices();
+
+    /**
+     * Appends a device and maps its current device id to it.
+     *
+     * @param device The device to add.
+     */
+    void Add(std::shared_ptr<IVRDevice> device);
+
+    /**
+     * Maps a tracker id to an already added device.
+     *
+     * @param id Tracker id.
+     * @param device The device the id should resolve to.
+     */
+    void MapId(int id, IVRDevice* device);
+
+    /**
+     * Returns the number of superseded snapshots not freed yet, because a reader may still use them.
+     */
+    size_t CountRetired();
+
+private:
+    struct Retired {
+        // generation that superseded the snapshot, readers that saw it don't use the snapshot anymore
+        uint64_t generation;
+        std::unique_ptr<const Snapshot> snapshot;
+    };
+
+    void Publish(std::unique_ptr<Snapshot> snapshot);
+    void FreeRetired();
+
+    std::mutex write_mutex_;
+    std::atomic<const Snapshot*> current_ = nullptr;
+    std::unique_ptr<const Snapshot> current_owner_;
+    std::vector<Retired> retired_;
+
+    // bumped by every publish, starts at 1 so a reader generation of 0 means offline
+    std::atomic<uint64_t> generation_ = 1;
+    // the generation every reader saw at its last quiescent point
+    mutable std::array<std::atomic<uint64_t>, static_cast<size_t>(Reader::COUNT)> reader_generations_{};
+};
+
+} // namespace SlimeVRDriver
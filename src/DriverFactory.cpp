@@ -25,3 +25,7 @@ void* HmdDriverFactory(const char* interface_name, int* return_code) {
 std::shared_ptr<SlimeVRDriver::IVRDriver> SlimeVRDriver::GetDriver() {
     return driver;
 }
+
+void SlimeVRDriver::SetDriver(std::shared_ptr<SlimeVRDriver::IVRDriver> new_driver) {
+    driver = new_driver;
+}
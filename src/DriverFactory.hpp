@@ -15,4 +15,9 @@ extern "C" void* HmdDriverFactory(const char* interface_name, int* return_code);
 
 namespace SlimeVRDriver {
 std::shared_ptr<SlimeVRDriver::IVRDriver> GetDriver();
+
+/**
+ * Replaces the driver returned by GetDriver, to run a driver outside of SteamVR.
+ */
+void SetDriver(std::shared_ptr<SlimeVRDriver::IVRDriver> new_driver);
 }
\ No newline at end of file
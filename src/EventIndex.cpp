@@ -0,0 +1,37 @@
+#include "EventIndex.hpp"
+
+#include <algorithm>
+
+void SlimeVRDriver::EventIndex::Build(const std::vector<vr::VREvent_t>& events) {
+    by_device_.clear();
+    by_component_.clear();
+    for (const auto& event : events) {
+        if (event.eventType == vr::VREvent_Input_HapticVibration) {
+            by_component_.push_back({ event.data.hapticVibration.componentHandle, &event });
+        } else {
+            by_device_.push_back({ event.trackedDeviceIndex, &event });
+        }
+    }
+
+    // events are contiguous, so comparing their addresses keeps the poll order within a key
+    auto by_key = [](const Entry& a, const Entry& b) {
+        return a.key != b.key ? a.key < b.key : a.event < b.event;
+    };
+    std::sort(by_device_.begin(), by_device_.end(), by_key);
+    std::sort(by_component_.begin(), by_component_.end(), by_key);
+}
+
+std::span<const SlimeVRDriver::EventIndex::Entry> SlimeVRDriver::EventIndex::ForDevice(vr::TrackedDeviceIndex_t index) const {
+    return Find(by_device_, index);
+}
+
+std::span<const SlimeVRDriver::EventIndex::Entry> SlimeVRDriver::EventIndex::ForHapticComponent(vr::VRInputComponentHandle_t component) const {
+    return Find(by_component_, component);
+}
+
+std::span<const SlimeVRDriver::EventIndex::Entry> SlimeVRDriver::EventIndex::Find(const std::vector<Entry>& entries, uint64_t key) {
+    auto [first, last] = std::equal_range(entries.begin(), entries.end(), Entry{ key, nullptr }, [](const Entry& a, const Entry& b) {
+        return a.key < b.key;
+    });
+    return { first, last };
+}
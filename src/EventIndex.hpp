@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <openvr_driver.h>
+
+namespace SlimeVRDriver {
+
+/**
+ * The OpenVR events of one frame, sorted once so every device only looks at its own events.
+ *
+ * Haptic vibration events are keyed by their input component handle, since their trackedDeviceIndex doesn't
+ * necessarily match the device the component belongs to. All other events are keyed by device index.
+ * Events keep the order they were polled in.
+ */
+class EventIndex {
+public:
+    struct Entry {
+        uint64_t key;
+        const vr::VREvent_t* event;
+    };
+
+    /**
+     * Rebuilds the index. The events must stay alive and unmodified until the next Build.
+     *
+     * @param events This frame's events.
+     */
+    void Build(const std::vector<vr::VREvent_t>& events);
+
+    /**
+     * Returns the events of a device, except haptic vibration events.
+     *
+     * @param index OpenVR device index.
+     */
+    std::span<const Entry> ForDevice(vr::TrackedDeviceIndex_t index) const;
+
+    /**
+     * Returns the haptic vibration events for an input component.
+     *
+     * @param component Haptic component handle.
+     */
+    std::span<const Entry> ForHapticComponent(vr::VRInputComponentHandle_t component) const;
+
+private:
+    static std::span<const Entry> Find(const std::vector<Entry>& entries, uint64_t key);
+
+    // capacity is kept between frames
+    std::vector<Entry> by_device_;
+    std::vector<Entry> by_component_;
+};
+
+} // namespace SlimeVRDriver
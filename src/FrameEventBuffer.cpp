@@ -0,0 +1,29 @@
+#include "FrameEventBuffer.hpp"
+
+SlimeVRDriver::FrameEventBuffer::FrameEventBuffer() {
+    for (auto& buffer : buffers_) {
+        buffer.reserve(kInitialCapacity);
+    }
+}
+
+void SlimeVRDriver::FrameEventBuffer::BeginFrame() {
+    buffers_[1 - front_].clear();
+}
+
+void SlimeVRDriver::FrameEventBuffer::Push(const vr::VREvent_t& event) {
+    buffers_[1 - front_].push_back(event);
+}
+
+void SlimeVRDriver::FrameEventBuffer::Publish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    front_ = 1 - front_;
+}
+
+const std::vector<vr::VREvent_t>& SlimeVRDriver::FrameEventBuffer::GetCurrent() const {
+    return buffers_[front_];
+}
+
+void SlimeVRDriver::FrameEventBuffer::CopyCurrent(std::vector<vr::VREvent_t>& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    out.assign(buffers_[front_].begin(), buffers_[front_].end());
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include <openvr_driver.h>
+
+namespace SlimeVRDriver {
+
+/**
+ * Double-buffered storage for the OpenVR events polled each frame.
+ *
+ * The frame thread collects events into the back buffer while the front buffer holds the previous frame's
+ * events, then Publish swaps the two. Both buffers are preallocated and keep their capacity, so collecting events
+ * doesn't allocate once the busiest frame so far has been seen.
+ */
+class FrameEventBuffer {
+public:
+    /**
+     * Events a buffer holds before it has to grow.
+     */
+    static constexpr size_t kInitialCapacity = 256;
+
+    FrameEventBuffer();
+
+    /**
+     * Frame thread: starts collecting a new frame's events.
+     */
+    void BeginFrame();
+
+    /**
+     * Frame thread: adds an event to the frame being collected.
+     */
+    void Push(const vr::VREvent_t& event);
+
+    /**
+     * Frame thread: makes the collected events the current ones.
+     */
+    void Publish();
+
+    /**
+     * Frame thread only: returns the current events. The reference is valid until the next Publish.
+     */
+    const std::vector<vr::VREvent_t>& GetCurrent() const;
+
+    /**
+     * Any thread: copies the current events.
+     *
+     * @param out Replaced with the current events, reuses its capacity.
+     */
+    void CopyCurrent(std::vector<vr::VREvent_t>& out) const;
+
+private:
+    std::array<std::vector<vr::VREvent_t>, 2> buffers_;
+    // only changed by the frame thread under mutex_, so the frame thread may read it without the lock
+    size_t front_ = 0;
+    mutable std::mutex mutex_;
+};
+
+} // namespace SlimeVRDriver
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "EventIndex.hpp"
 #include "ProtobufMessages.pb.h"
 #include <DeviceType.hpp>
+#include <chrono>
 #include <openvr_driver.h>
 #include <variant>
 
@@ -19,8 +21,10 @@ public:
     /**
      * Runs any update logic for this device.
      * Called once per frame.
+     *
+     * @param events This frame's OpenVR events.
      */
-    virtual void Update() = 0;
+    virtual void Update(const EventIndex& events) = 0;
 
     /**
      * Returns the OpenVR device index.
@@ -67,8 +71,11 @@ public:
 
     /**
      * Updates device position from a received message.
+     *
+     * @param position The received message.
+     * @param received_at Time the message was read from the bridge.
      */
-    virtual void PositionMessage(messages::Position& position) = 0;
+    virtual void PositionMessage(messages::Position& position, std::chrono::steady_clock::time_point received_at) = 0;
 
     /**
      * Updates device status from a received message.
@@ -80,6 +87,14 @@ public:
      */
     virtual void BatteryMessage(messages::Battery& battery) = 0;
 
+    /**
+     * Sends the newest pose to SteamVR if it hasn't been submitted yet.
+     * Called by the pose submission stage when poses aren't submitted from the bridge thread.
+     *
+     * @return True if a pose was submitted.
+     */
+    virtual bool SubmitPendingPose() = 0;
+
     // Inherited via ITrackedDeviceServerDriver
     virtual vr::EVRInitError Activate(uint32_t unObjectId) = 0;
     virtual void Deactivate() = 0;
@@ -1,10 +1,14 @@
 #pragma once
 #include "IVRDevice.hpp"
+#include "LatencyHistogram.hpp"
+#include "PoseSubmitter.hpp"
 #include <chrono>
 #include <memory>
 #include <openvr_driver.h>
 #include <optional>
 #include <simdjson.h>
+#include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -19,6 +23,36 @@ public:
     static UniverseTranslation parse(simdjson::ondemand::object& obj);
 };
 
+/**
+ * Transforms between the driver and the current universe, computed once when the universe changes.
+ */
+struct UniverseTransform {
+    // incremented every time a universe is published, 0 if none was found yet
+    uint64_t generation = 0;
+    // passed to SteamVR with every device pose
+    double world_from_driver_translation[3] = { 0.0, 0.0, 0.0 };
+    vr::HmdQuaternion_t world_from_driver_rotation = { 1.0, 0.0, 0.0, 0.0 };
+    // cos and sin of the universe yaw, for rotating positions on the xz plane
+    float cos_yaw = 1.f;
+    float sin_yaw = 0.f;
+
+    /**
+     * Computes the transforms for a universe. NaN components are replaced with 0.
+     *
+     * @param trans Universe translation and yaw.
+     * @param generation Generation of the new transform.
+     */
+    static UniverseTransform FromTranslation(const UniverseTranslation& trans, uint64_t generation);
+
+    /**
+     * Moves a pose from driver space into the universe, the inverse of the world-from-driver transform.
+     *
+     * @param q Rotation, transformed in place.
+     * @param pos Position, transformed in place.
+     */
+    void ToUniverse(vr::HmdQuaternion_t& q, vr::HmdVector3_t& pos) const;
+};
+
 typedef std::variant<std::monostate, std::string, int, float, bool> SettingsValue;
 
 class IVRDriver : protected vr::IServerTrackedDeviceProvider {
@@ -32,11 +66,19 @@ public:
 
     /**
      * Returns all OpenVR events that happened on the current frame.
+     * Only valid on SteamVR's frame thread, until the next RunFrame.
      *
      * @return A vector of current frame's OpenVR events.
      */
     virtual const std::vector<vr::VREvent_t>& GetOpenVREvents() = 0;
 
+    /**
+     * Copies all OpenVR events that happened on the current frame. Safe to call from any thread.
+     *
+     * @param out Replaced with the current frame's OpenVR events.
+     */
+    virtual void CopyOpenVREvents(std::vector<vr::VREvent_t>& out) = 0;
+
     /**
      * Returns the milliseconds between last frame and this frame.
      *
@@ -82,9 +124,57 @@ public:
     virtual vr::IVRServerDriverHost* GetDriverHost() = 0;
 
     /**
-     * Gets the current UniverseTranslation.
+     * Sends a message to the server. Safe to call from any thread, the message is dropped while disconnected.
+     *
+     * @param message Message to send.
+     */
+    virtual void SendBridgeMessage(const messages::ProtobufMessage& message) = 0;
+
+    /**
+     * Gets the protocol version the server announced. Messages newer than the server's version are dropped by it,
+     * callers check this before sending them.
+     *
+     * @return The server's protocol version, 0 while disconnected or before it sent its version.
+     */
+    virtual int32_t GetServerProtocolVersion() = 0;
+
+    /**
+     * Gets the stage that decides when device poses are passed to SteamVR.
+     *
+     * @return The pose submission stage.
+     */
+    virtual PoseSubmitter& GetPoseSubmitter() = 0;
+
+    /**
+     * Gets the generation of the current universe transform. Cheap enough to call for every pose, so callers can keep
+     * a copy of the transform and only refresh it when the generation changes.
+     *
+     * @return The generation of the transform GetUniverseTransform would return.
+     */
+    virtual uint64_t GetUniverseGeneration() = 0;
+
+    /**
+     * Gets the current universe transform. Safe to call from any thread.
+     *
+     * @return The current transform, with a generation of 0 if no universe was found yet.
+     */
+    virtual UniverseTransform GetUniverseTransform() = 0;
+
+    /**
+     * Gets the latency from reading a pose from the bridge to passing it to SteamVR. Devices record into it for every
+     * TrackedDevicePoseUpdated call.
+     *
+     * @return The histogram to record into.
+     */
+    virtual LatencyHistogram& GetReadToSubmitLatency() = 0;
+
+    /**
+     * Answers driver-wide debug requests, which devices forward from their own DebugRequest.
+     *
+     * @param request The request, e.g. "latency".
+     * @return The response, empty for unknown requests.
      */
-    virtual std::optional<UniverseTranslation> GetCurrentUniverse() = 0;
+    virtual std::string DebugRequest(std::string_view request) = 0;
 
     virtual inline const char* const* GetInterfaceVersions() override {
         return vr::k_InterfaceVersions;
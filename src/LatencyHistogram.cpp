@@ -0,0 +1,74 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+
+void SlimeVRDriver::LatencyHistogram::Record(std::chrono::steady_clock::duration latency) {
+    auto value_us = static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count(), 0));
+    buckets_[BucketIndex(value_us)].fetch_add(1, std::memory_order_relaxed);
+    sum_us_.fetch_add(value_us, std::memory_order_relaxed);
+    uint64_t max = max_us_.load(std::memory_order_relaxed);
+    while (value_us > max && !max_us_.compare_exchange_weak(max, value_us, std::memory_order_relaxed)) { }
+}
+
+SlimeVRDriver::LatencyHistogram::Summary SlimeVRDriver::LatencyHistogram::Summarize() const {
+    std::array<uint64_t, kBucketCount> counts;
+    Summary summary;
+    for (size_t i = 0; i < kBucketCount; i++) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        summary.count += counts[i];
+    }
+    if (!summary.count)
+        return summary;
+    summary.mean_us = static_cast<double>(sum_us_.load(std::memory_order_relaxed)) / summary.count;
+    summary.max_us = max_us_.load(std::memory_order_relaxed);
+
+    auto percentile = [&](double fraction) {
+        // the smallest bucket that has at least this fraction of the values at or below it
+        auto rank = static_cast<uint64_t>(std::ceil(fraction * summary.count));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; i++) {
+            seen += counts[i];
+            if (seen >= rank)
+                return std::min(BucketUpperBound(i), summary.max_us);
+        }
+        return summary.max_us;
+    };
+    summary.p50_us = percentile(0.5);
+    summary.p90_us = percentile(0.9);
+    summary.p99_us = percentile(0.99);
+    summary.p999_us = percentile(0.999);
+    return summary;
+}
+
+std::string SlimeVRDriver::LatencyHistogram::ToJson() const {
+    Summary summary = Summarize();
+    return std::format(
+        R"({{"count":{},"mean_us":{:.1f},"p50_us":{},"p90_us":{},"p99_us":{},"p999_us":{},"max_us":{}}})",
+        summary.count,
+        summary.mean_us,
+        summary.p50_us,
+        summary.p90_us,
+        summary.p99_us,
+        summary.p999_us,
+        summary.max_us);
+}
+
+size_t SlimeVRDriver::LatencyHistogram::BucketIndex(uint64_t value_us) {
+    value_us = std::min(value_us, (uint64_t(1) << kMaxValueBits) - 1);
+    // values below kSubBuckets get a bucket each
+    if (value_us < kSubBuckets)
+        return static_cast<size_t>(value_us);
+    int shift = std::bit_width(value_us) - 1 - kSubBucketBits;
+    return static_cast<size_t>((shift + 1) * kSubBuckets + ((value_us >> shift) - kSubBuckets));
+}
+
+uint64_t SlimeVRDriver::LatencyHistogram::BucketUpperBound(size_t index) {
+    if (index < kSubBuckets)
+        return index;
+    int shift = static_cast<int>(index / kSubBuckets) - 1;
+    uint64_t lower = (kSubBuckets + index % kSubBuckets) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace SlimeVRDriver {
+
+/**
+ * Histogram of latencies in microseconds with logarithmic buckets, like HdrHistogram: every power of two is split into
+ * kSubBuckets linear buckets, so a bucket is at most 1/kSubBuckets of its value wide.
+ *
+ * Recording is a few relaxed atomic increments and never blocks, so it can be left on in the hot paths of any thread.
+ * Reading walks all buckets and is meant for occasional queries.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr uint64_t kSubBuckets = 1 << kSubBucketBits;
+    // larger values are counted in the last bucket, 2^32us is over an hour
+    static constexpr int kMaxValueBits = 32;
+    static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+    struct Summary {
+        uint64_t count = 0;
+        double mean_us = 0.0;
+        uint64_t p50_us = 0;
+        uint64_t p90_us = 0;
+        uint64_t p99_us = 0;
+        uint64_t p999_us = 0;
+        uint64_t max_us = 0;
+    };
+
+    void Record(std::chrono::steady_clock::duration latency);
+
+    /**
+     * Percentiles are reported as the upper bound of their bucket, but never above the largest recorded value.
+     * Values recorded concurrently may or may not be included.
+     */
+    Summary Summarize() const;
+
+    /**
+     * Returns the summary as a JSON object.
+     */
+    std::string ToJson() const;
+
+    static size_t BucketIndex(uint64_t value_us);
+
+    /**
+     * Returns the largest value counted in a bucket.
+     */
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+    std::atomic<uint64_t> sum_us_ = 0;
+    std::atomic<uint64_t> max_us_ = 0;
+};
+
+} // namespace SlimeVRDriver
@@ -0,0 +1,46 @@
+#include "LogRateLimiter.hpp"
+
+bool SlimeVRDriver::LogRateLimiter::Allow(const char* site, uint64_t key, Clock::time_point now, uint64_t& suppressed) {
+    suppressed = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find({ site, key });
+    if (it == entries_.end()) {
+        if (entries_.size() < kMaxEntries) {
+            entries_.emplace(std::make_pair(site, key), Entry{ now });
+        }
+        return true;
+    }
+
+    Entry& entry = it->second;
+    if (now - entry.written_at < interval_) {
+        entry.suppressed++;
+        return false;
+    }
+    suppressed = entry.suppressed;
+    entry = Entry{ now };
+    return true;
+}
+
+std::vector<SlimeVRDriver::LogRateLimiter::Suppressed> SlimeVRDriver::LogRateLimiter::TakeSuppressed(Clock::time_point now) {
+    std::vector<Suppressed> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        Entry& entry = it->second;
+        if (now - entry.written_at < interval_) {
+            ++it;
+        } else if (entry.suppressed) {
+            // still repeating, the summary starts a new interval
+            result.push_back({ it->first.first, it->first.second, entry.suppressed });
+            entry = Entry{ now };
+            ++it;
+        } else {
+            it = entries_.erase(it);
+        }
+    }
+    return result;
+}
+
+void SlimeVRDriver::LogRateLimiter::SetInterval(Clock::duration interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interval_ = interval;
+}
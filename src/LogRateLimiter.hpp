@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace SlimeVRDriver {
+
+/**
+ * Decides which repeats of a log message are written. A message is identified by its call site and a key, e.g. the
+ * device index, and written at most once per interval. Repeats within the interval are only counted, and the count is
+ * reported with the next message that is written, or by TakeSuppressed once the interval passed.
+ */
+class LogRateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr Clock::duration kDefaultInterval = std::chrono::seconds(10);
+    // beyond this many distinct messages per interval everything is written
+    static constexpr size_t kMaxEntries = 256;
+
+    struct Suppressed {
+        const char* site;
+        uint64_t key;
+        uint64_t count;
+    };
+
+    /**
+     * Counts an occurrence of a message.
+     *
+     * @param site Identifies the call site, e.g. its format string.
+     * @param key Distinguishes messages from the same call site.
+     * @param now Time of the occurrence.
+     * @param suppressed Set to the number of repeats that weren't written since it was last written.
+     * @return True if the message should be written.
+     */
+    bool Allow(const char* site, uint64_t key, Clock::time_point now, uint64_t& suppressed);
+
+    /**
+     * Returns the repeat counts of messages that didn't occur again for an interval after being suppressed, and
+     * forgets messages that haven't occurred for an interval.
+     */
+    std::vector<Suppressed> TakeSuppressed(Clock::time_point now);
+
+    void SetInterval(Clock::duration interval);
+
+private:
+    struct Entry {
+        Clock::time_point written_at;
+        uint64_t suppressed = 0;
+    };
+
+    std::mutex mutex_;
+    Clock::duration interval_ = kDefaultInterval;
+    std::map<std::pair<const char*, uint64_t>, Entry> entries_;
+};
+
+} // namespace SlimeVRDriver
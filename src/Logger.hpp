@@ -1,29 +1,176 @@
 #pragma once
+#include <atomic>
 #include <format>
 #include <iostream>
 #include <mutex>
 #include <openvr_driver.h>
 #include <string>
+#include <string_view>
 #include <thread>
 
+#include "AsyncLogQueue.hpp"
+#include "LogRateLimiter.hpp"
+
+// prefixed, windows.h defines ERROR
+enum class LogLevel {
+    // per pose or per frame diagnostics
+    LOG_TRACE,
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR,
+    LOG_OFF,
+};
+
+// Calls below this level are compiled out, set with -DSLIMEVR_LOG_LEVEL=<0 for LOG_TRACE to 5 for LOG_OFF>. Release
+// builds keep LOG_DEBUG so it can be enabled with the logLevel setting.
+#ifndef SLIMEVR_LOG_LEVEL
+#ifdef _DEBUG
+#define SLIMEVR_LOG_LEVEL 0
+#else
+#define SLIMEVR_LOG_LEVEL 1
+#endif
+#endif
+inline constexpr LogLevel kMinLogLevel = static_cast<LogLevel>(SLIMEVR_LOG_LEVEL);
+
+/**
+ * Parses the logLevel setting.
+ *
+ * @param name "trace", "debug", "info", "warning", "error" or "off".
+ * @return The matching level, LOG_INFO for anything else.
+ */
+inline LogLevel ParseLogLevel(std::string_view name) {
+    if (name == "trace")
+        return LogLevel::LOG_TRACE;
+    if (name == "debug")
+        return LogLevel::LOG_DEBUG;
+    if (name == "warning")
+        return LogLevel::LOG_WARNING;
+    if (name == "error")
+        return LogLevel::LOG_ERROR;
+    if (name == "off")
+        return LogLevel::LOG_OFF;
+    return LogLevel::LOG_INFO;
+}
+
 class Logger {
 public:
+    // longer messages are truncated
+    static constexpr size_t kMaxMessageLength = SlimeVRDriver::AsyncLogQueue::kMaxMessageLength;
+
     Logger()
         : name_("") { }
     Logger(const std::string& name)
         : name_(name) { }
+
+    /**
+     * Logs a message at Level. Messages below kMinLogLevel are compiled out, messages below the runtime level aren't
+     * formatted.
+     */
+    template <LogLevel Level, typename... Args>
+    void LogAt(const std::format_string<Args...> format_str, Args&&... args) {
+        if constexpr (Level >= kMinLogLevel) {
+            if (Level >= GetLevel())
+                Write(0, format_str, std::forward<Args>(args)...);
+        }
+    };
+
     template <typename... Args>
     void Log(const std::format_string<Args...> format_str, Args&&... args) {
-        std::string message = std::vformat(format_str.get(), std::make_format_args(args...));
-        std::string prefixed = name_.length() ? std::format("{}: {}", name_, message) : message;
-        std::lock_guard<std::mutex> lock(mutex_);
-        LogImpl(prefixed.c_str());
+        LogAt<LogLevel::LOG_INFO>(format_str, std::forward<Args>(args)...);
     };
 
+    template <typename... Args>
+    void Trace(const std::format_string<Args...> format_str, Args&&... args) {
+        LogAt<LogLevel::LOG_TRACE>(format_str, std::forward<Args>(args)...);
+    };
+
+    template <typename... Args>
+    void Debug(const std::format_string<Args...> format_str, Args&&... args) {
+        LogAt<LogLevel::LOG_DEBUG>(format_str, std::forward<Args>(args)...);
+    };
+
+    template <typename... Args>
+    void Warning(const std::format_string<Args...> format_str, Args&&... args) {
+        LogAt<LogLevel::LOG_WARNING>(format_str, std::forward<Args>(args)...);
+    };
+
+    template <typename... Args>
+    void Error(const std::format_string<Args...> format_str, Args&&... args) {
+        LogAt<LogLevel::LOG_ERROR>(format_str, std::forward<Args>(args)...);
+    };
+
+    /**
+     * Logs like Log, but writes a message from the same call site with the same key at most once per rate limit
+     * interval, for errors that can repeat on every iteration of a loop. The next written message says how many
+     * repeats were suppressed. Logs at Warning level, compiled out like LogAt.
+     *
+     * @param key Distinguishes messages from the same call site, e.g. the device index.
+     */
+    template <typename... Args>
+    void LogRateLimited(uint64_t key, const std::format_string<Args...> format_str, Args&&... args) {
+        if constexpr (LogLevel::LOG_WARNING >= kMinLogLevel) {
+            if (LogLevel::LOG_WARNING < GetLevel())
+                return;
+            uint64_t suppressed;
+            // identical format strings are the same call site as far as readers of the log are concerned
+            if (rate_limiter_.Allow(format_str.get().data(), key, std::chrono::steady_clock::now(), suppressed)) {
+                Write(suppressed, format_str, std::forward<Args>(args)...);
+            }
+        }
+    };
+
+    /**
+     * Writes how often messages were suppressed by LogRateLimited if they stopped repeating. Meant to be called
+     * periodically.
+     */
+    void FlushSuppressed() {
+        if constexpr (LogLevel::LOG_WARNING >= kMinLogLevel) {
+            if (LogLevel::LOG_WARNING < GetLevel())
+                return;
+            for (const auto& entry : rate_limiter_.TakeSuppressed(std::chrono::steady_clock::now())) {
+                Write(0, "suppressed {} times (key {}): {}", entry.count, entry.key, entry.site);
+            }
+        }
+    }
+
+    /**
+     * Sets the runtime level of all loggers, messages below it aren't written.
+     */
+    static void SetLevel(LogLevel level) {
+        level_.store(level, std::memory_order_relaxed);
+    }
+
+    static LogLevel GetLevel() {
+        return level_.load(std::memory_order_relaxed);
+    }
+
+    void SetRateLimitInterval(std::chrono::steady_clock::duration interval) {
+        rate_limiter_.SetInterval(interval);
+    }
+
 protected:
     virtual void LogImpl(const char* string) = 0;
     std::string name_;
-    std::mutex mutex_;
+
+private:
+    template <typename... Args>
+    void Write(uint64_t suppressed, const std::format_string<Args...> format_str, Args&&... args) {
+        // formatted on the stack so logging doesn't allocate, unless formatting an argument does
+        char buffer[kMaxMessageLength + 1];
+        char* out = buffer;
+        char* end = buffer + kMaxMessageLength;
+        if (name_.length())
+            out = std::format_to_n(out, end - out, "{}: ", name_).out;
+        out = std::format_to_n(out, end - out, format_str, std::forward<Args>(args)...).out;
+        if (suppressed)
+            out = std::format_to_n(out, end - out, " (suppressed {} times)", suppressed).out;
+        *out = '\0';
+        LogImpl(buffer);
+    }
+
+    SlimeVRDriver::LogRateLimiter rate_limiter_;
+    static inline std::atomic<LogLevel> level_ = LogLevel::LOG_INFO;
 };
 
 class NullLogger : public Logger {
@@ -38,9 +185,13 @@ class ConsoleLogger : public Logger {
 
 protected:
     void LogImpl(const char* message) override {
+        std::lock_guard<std::mutex> lock(mutex_);
         std::cout << message << '\n'
                   << std::flush;
     }
+
+private:
+    std::mutex mutex_;
 };
 
 class VRLogger : public Logger {
@@ -48,6 +199,12 @@ class VRLogger : public Logger {
 
 protected:
     void LogImpl(const char* message) override {
-        vr::VRDriverLog()->Log(message);
+        // queued while the driver runs, so the calling thread never waits for vrserver
+        auto& queue = SlimeVRDriver::AsyncLogQueue::ForDriverLog();
+        if (queue.IsRunning()) {
+            queue.Push(message);
+        } else {
+            vr::VRDriverLog()->Log(message);
+        }
     }
 };
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cmath>
+
+#include <openvr_driver.h>
+
+#include "PoseMath.hpp"
+
+namespace SlimeVRDriver {
+
+/**
+ * Parameters of a One-Euro filter (Casiez et al., 2012).
+ *
+ * The cutoff frequency rises with speed: min_cutoff + beta * speed. Slow movements are smoothed heavily, which
+ * removes jitter, while fast movements pass with almost no lag.
+ */
+struct OneEuroParams {
+    // cutoff at rest in Hz, lower means smoother but laggier
+    double min_cutoff = 1.0;
+    // how quickly the cutoff rises with speed, in Hz per unit of speed
+    double beta = 0.0;
+    // cutoff for the speed estimate in Hz
+    double derivative_cutoff = 1.0;
+};
+
+/**
+ * Smoothing factor of an exponential low-pass filter with the given cutoff, sampled every `dt` seconds.
+ */
+inline double OneEuroAlpha(double cutoff, double dt) {
+    constexpr double kTwoPi = 6.28318530717958647692;
+    double tau = 1.0 / (kTwoPi * cutoff);
+    return 1.0 / (1.0 + tau / dt);
+}
+
+/**
+ * One-Euro filter on a 3D position. Speed is the length of the velocity, so all axes share one cutoff.
+ */
+class OneEuroPositionFilter {
+public:
+    void SetParams(const OneEuroParams& params) {
+        params_ = params;
+    }
+
+    void Reset() {
+        initialized_ = false;
+    }
+
+    /**
+     * Filters a sample in place.
+     *
+     * @param position Raw position, replaced with the filtered one.
+     * @param dt Seconds since the previous sample.
+     */
+    void Filter(double (&position)[3], double dt) {
+        if (!initialized_ || !(dt > 0.0)) {
+            for (int i = 0; i < 3; i++) {
+                value_[i] = position[i];
+                if (!initialized_)
+                    derivative_[i] = 0.0;
+            }
+            initialized_ = true;
+            return;
+        }
+
+        double derivative_alpha = OneEuroAlpha(params_.derivative_cutoff, dt);
+        double speed_squared = 0.0;
+        for (int i = 0; i < 3; i++) {
+            double derivative = (position[i] - value_[i]) / dt;
+            derivative_[i] += derivative_alpha * (derivative - derivative_[i]);
+            speed_squared += derivative_[i] * derivative_[i];
+        }
+
+        double alpha = OneEuroAlpha(params_.min_cutoff + params_.beta * std::sqrt(speed_squared), dt);
+        for (int i = 0; i < 3; i++) {
+            value_[i] += alpha * (position[i] - value_[i]);
+            position[i] = value_[i];
+        }
+    }
+
+private:
+    OneEuroParams params_;
+    bool initialized_ = false;
+    double value_[3] = {};
+    double derivative_[3] = {};
+};
+
+/**
+ * One-Euro filter on a rotation. The speed is the angular speed and smoothing is a slerp towards the new sample.
+ */
+class OneEuroRotationFilter {
+public:
+    void SetParams(const OneEuroParams& params) {
+        params_ = params;
+    }
+
+    void Reset() {
+        initialized_ = false;
+    }
+
+    /**
+     * Filters a sample in place.
+     *
+     * @param rotation Raw rotation, replaced with the filtered one.
+     * @param dt Seconds since the previous sample.
+     */
+    void Filter(vr::HmdQuaternion_t& rotation, double dt) {
+        if (!initialized_ || !(dt > 0.0)) {
+            value_ = rotation;
+            if (!initialized_)
+                angular_speed_ = 0.0;
+            initialized_ = true;
+            return;
+        }
+
+        double delta[3];
+        QuatToRotationVector(QuatMultiply(rotation, QuatConjugate(value_)), delta);
+        double angular_speed = std::sqrt(delta[0] * delta[0] + delta[1] * delta[1] + delta[2] * delta[2]) / dt;
+        angular_speed_ += OneEuroAlpha(params_.derivative_cutoff, dt) * (angular_speed - angular_speed_);
+
+        double alpha = OneEuroAlpha(params_.min_cutoff + params_.beta * angular_speed_, dt);
+        value_ = QuatSlerp(value_, rotation, alpha);
+        rotation = value_;
+    }
+
+private:
+    OneEuroParams params_;
+    bool initialized_ = false;
+    vr::HmdQuaternion_t value_ = { 1.0, 0.0, 0.0, 0.0 };
+    double angular_speed_ = 0.0;
+};
+
+/**
+ * Per-tracker smoothing of received poses, disabled unless parameters were set.
+ */
+class PoseFilter {
+public:
+    // gaps longer than this don't describe the current motion, the filter starts over
+    static constexpr double kResetAfterSeconds = 0.5;
+
+    /**
+     * Enables the filter with the given parameters and forgets the filter state.
+     */
+    void Enable(const OneEuroParams& position, const OneEuroParams& rotation) {
+        position_.SetParams(position);
+        rotation_.SetParams(rotation);
+        enabled_ = true;
+        Reset();
+    }
+
+    bool IsEnabled() const {
+        return enabled_;
+    }
+
+    /**
+     * Forgets the filter state, the next sample passes unfiltered.
+     */
+    void Reset() {
+        position_.Reset();
+        rotation_.Reset();
+    }
+
+    /**
+     * Filters the position and rotation of a pose in place.
+     *
+     * @param pose Pose to filter.
+     * @param dt Seconds since the previous pose.
+     */
+    void Filter(vr::DriverPose_t& pose, double dt) {
+        if (!enabled_)
+            return;
+        if (dt > kResetAfterSeconds)
+            Reset();
+        position_.Filter(pose.vecPosition, dt);
+        rotation_.Filter(pose.qRotation, dt);
+    }
+
+private:
+    bool enabled_ = false;
+    OneEuroPositionFilter position_;
+    OneEuroRotationFilter rotation_;
+};
+
+} // namespace SlimeVRDriver
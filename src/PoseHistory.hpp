@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "PoseMath.hpp"
+#include "SeqLock.hpp"
+
+namespace SlimeVRDriver {
+
+/**
+ * Ring of the most recent timestamped poses of a tracker, for resampling them at a different rate.
+ *
+ * One thread pushes poses while others sample the history. Slots are seqlocks, so a reader never sees a
+ * half-written pose, and a reader that got lapped by the writer stops at the first slot that was overwritten.
+ */
+class PoseHistory {
+public:
+    /**
+     * Poses kept, 160ms worth at 200Hz.
+     */
+    static constexpr size_t kCapacity = 32;
+
+    enum class SampleResult {
+        // nothing was pushed yet
+        EMPTY,
+        // the time is older than every kept pose, the oldest one was returned
+        BEFORE_OLDEST,
+        // the time lies between two poses, the result was interpolated
+        INTERPOLATED,
+        // the time is at or after the newest pose, the newest one was returned
+        AFTER_NEWEST,
+    };
+
+    /**
+     * Adds a pose. Times must not go backwards. Only one thread may push.
+     */
+    void Push(const TimedPose& pose) {
+        uint64_t count = count_.load(std::memory_order_relaxed);
+        slots_[count % kCapacity].Store(pose);
+        count_.store(count + 1, std::memory_order_release);
+    }
+
+    /**
+     * Resamples the history at a point in time.
+     *
+     * @param time Time to sample at.
+     * @param out Set to the sampled pose, unless the history is empty.
+     * @return Where the time lies relative to the kept poses.
+     */
+    SampleResult Sample(std::chrono::steady_clock::time_point time, TimedPose& out) const {
+        uint64_t count = count_.load(std::memory_order_acquire);
+        if (count == 0)
+            return SampleResult::EMPTY;
+
+        TimedPose newer = slots_[(count - 1) % kCapacity].Load();
+        if (time >= newer.time) {
+            out = newer;
+            return SampleResult::AFTER_NEWEST;
+        }
+
+        uint64_t kept = count < kCapacity ? count : kCapacity;
+        for (uint64_t i = 2; i <= kept; i++) {
+            TimedPose older = slots_[(count - i) % kCapacity].Load();
+            // the writer got around the ring and replaced this slot with a newer pose
+            if (older.time > newer.time)
+                break;
+            if (time >= older.time) {
+                out = InterpolatePose(older, newer, time);
+                return SampleResult::INTERPOLATED;
+            }
+            newer = older;
+        }
+
+        out = newer;
+        return SampleResult::BEFORE_OLDEST;
+    }
+
+private:
+    std::array<SeqLock<TimedPose>, kCapacity> slots_;
+    std::atomic<uint64_t> count_ = 0;
+};
+
+} // namespace SlimeVRDriver
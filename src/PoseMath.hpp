@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <openvr_driver.h>
+
+namespace SlimeVRDriver {
+
+/**
+ * A pose together with the time it was received from the server.
+ */
+struct TimedPose {
+    vr::DriverPose_t pose;
+    std::chrono::steady_clock::time_point time;
+};
+
+inline vr::HmdQuaternion_t QuatMultiply(const vr::HmdQuaternion_t& a, const vr::HmdQuaternion_t& b) {
+    vr::HmdQuaternion_t q;
+    q.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+    q.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+    q.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+    q.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+    return q;
+}
+
+inline vr::HmdQuaternion_t QuatConjugate(const vr::HmdQuaternion_t& q) {
+    return { q.w, -q.x, -q.y, -q.z };
+}
+
+inline vr::HmdQuaternion_t QuatNormalize(const vr::HmdQuaternion_t& q) {
+    double norm = std::sqrt(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+    if (norm == 0.0)
+        return { 1.0, 0.0, 0.0, 0.0 };
+    return { q.w / norm, q.x / norm, q.y / norm, q.z / norm };
+}
+
+/**
+ * Spherical linear interpolation from `a` (t = 0) to `b` (t = 1), taking the shortest path.
+ */
+inline vr::HmdQuaternion_t QuatSlerp(const vr::HmdQuaternion_t& a, vr::HmdQuaternion_t b, double t) {
+    double cos_angle = a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z;
+    if (cos_angle < 0) {
+        b = { -b.w, -b.x, -b.y, -b.z };
+        cos_angle = -cos_angle;
+    }
+
+    double wa = 1.0 - t;
+    double wb = t;
+    // nearly identical rotations, sin(angle) is too small to divide by and lerp is exact enough
+    if (cos_angle < 1.0 - 1e-7) {
+        double angle = std::acos(cos_angle);
+        double sin_angle = std::sin(angle);
+        wa = std::sin((1.0 - t) * angle) / sin_angle;
+        wb = std::sin(t * angle) / sin_angle;
+    }
+    return QuatNormalize({ wa * a.w + wb * b.w, wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z });
+}
+
+/**
+ * Builds the rotation described by a rotation vector (axis scaled by angle in radians).
+ */
+inline vr::HmdQuaternion_t QuatFromRotationVector(const double (&v)[3]) {
+    double angle = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    if (angle < 1e-12)
+        return QuatNormalize({ 1.0, v[0] / 2, v[1] / 2, v[2] / 2 });
+    double s = std::sin(angle / 2) / angle;
+    return { std::cos(angle / 2), v[0] * s, v[1] * s, v[2] * s };
+}
+
+/**
+ * Returns the rotation vector (axis scaled by angle in radians) of a rotation, taking the shortest path.
+ */
+inline void QuatToRotationVector(vr::HmdQuaternion_t q, double (&out)[3]) {
+    if (q.w < 0)
+        q = { -q.w, -q.x, -q.y, -q.z };
+    double sin_half = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+    double angle = 2 * std::atan2(sin_half, q.w);
+    // angle / sin(angle / 2) tends to 2 for small angles
+    double scale = sin_half < 1e-12 ? 2.0 : angle / sin_half;
+    out[0] = q.x * scale;
+    out[1] = q.y * scale;
+    out[2] = q.z * scale;
+}
+
+/**
+ * Derives the angular velocity, in the same frame as the rotations, that turns `from` into `to` in `dt` seconds.
+ * This is the axis-angle representation DriverPose_t::vecAngularVelocity uses.
+ */
+inline void AngularVelocityBetween(const vr::HmdQuaternion_t& from, const vr::HmdQuaternion_t& to, double dt, double (&out)[3]) {
+    QuatToRotationVector(QuatMultiply(to, QuatConjugate(from)), out);
+    for (double& v : out)
+        v /= dt;
+}
+
+/**
+ * Moves a pose `dt` seconds forward using its linear and angular velocity and acceleration, the same way SteamVR
+ * predicts it.
+ */
+inline void ExtrapolatePose(vr::DriverPose_t& pose, double dt) {
+    for (int i = 0; i < 3; i++)
+        pose.vecPosition[i] += (pose.vecVelocity[i] + 0.5 * pose.vecAcceleration[i] * dt) * dt;
+
+    double rotation[3] = {
+        (pose.vecAngularVelocity[0] + 0.5 * pose.vecAngularAcceleration[0] * dt) * dt,
+        (pose.vecAngularVelocity[1] + 0.5 * pose.vecAngularAcceleration[1] * dt) * dt,
+        (pose.vecAngularVelocity[2] + 0.5 * pose.vecAngularAcceleration[2] * dt) * dt,
+    };
+    pose.qRotation = QuatNormalize(QuatMultiply(QuatFromRotationVector(rotation), pose.qRotation));
+}
+
+/**
+ * Interpolates between two timed poses: positions, velocities and accelerations linearly, the rotation with slerp.
+ * The remaining fields, like the tracking state, are taken from `b`.
+ *
+ * @param a Older pose.
+ * @param b Newer pose.
+ * @param time Time to interpolate at, clamped to [a.time, b.time].
+ */
+inline TimedPose InterpolatePose(const TimedPose& a, const TimedPose& b, std::chrono::steady_clock::time_point time) {
+    double span = std::chrono::duration<double>(b.time - a.time).count();
+    double t = span > 0.0 ? std::clamp(std::chrono::duration<double>(time - a.time).count() / span, 0.0, 1.0) : 1.0;
+
+    TimedPose result = b;
+    result.time = std::clamp(time, a.time, b.time);
+    for (int i = 0; i < 3; i++) {
+        result.pose.vecPosition[i] = a.pose.vecPosition[i] + (b.pose.vecPosition[i] - a.pose.vecPosition[i]) * t;
+        result.pose.vecVelocity[i] = a.pose.vecVelocity[i] + (b.pose.vecVelocity[i] - a.pose.vecVelocity[i]) * t;
+        result.pose.vecAngularVelocity[i] = a.pose.vecAngularVelocity[i] + (b.pose.vecAngularVelocity[i] - a.pose.vecAngularVelocity[i]) * t;
+        result.pose.vecAcceleration[i] = a.pose.vecAcceleration[i] + (b.pose.vecAcceleration[i] - a.pose.vecAcceleration[i]) * t;
+        result.pose.vecAngularAcceleration[i] = a.pose.vecAngularAcceleration[i] + (b.pose.vecAngularAcceleration[i] - a.pose.vecAngularAcceleration[i]) * t;
+    }
+    result.pose.qRotation = QuatSlerp(a.pose.qRotation, b.pose.qRotation, t);
+    return result;
+}
+
+/**
+ * Prepares a pose received `age` seconds ago for submission to SteamVR.
+ *
+ * Within `max_horizon` the pose is left as is and poseTimeOffset is set to -age, so SteamVR extrapolates it to the
+ * submission time with its velocities. Past the horizon the pose is extrapolated to the horizon and its velocities are
+ * cleared, so a stalled tracker stops at the horizon instead of drifting away.
+ */
+inline vr::DriverPose_t ExtrapolatePoseForSubmit(vr::DriverPose_t pose, double age, double max_horizon) {
+    age = std::max(age, 0.0);
+    if (age <= max_horizon) {
+        pose.poseTimeOffset = -age;
+        return pose;
+    }
+
+    ExtrapolatePose(pose, max_horizon);
+    for (int i = 0; i < 3; i++) {
+        pose.vecVelocity[i] = 0.0;
+        pose.vecAngularVelocity[i] = 0.0;
+        pose.vecAcceleration[i] = 0.0;
+        pose.vecAngularAcceleration[i] = 0.0;
+    }
+    pose.poseTimeOffset = 0.0;
+    return pose;
+}
+
+} // namespace SlimeVRDriver
@@ -0,0 +1,107 @@
+#include "PoseSubmitter.hpp"
+
+SlimeVRDriver::PoseSubmitMode SlimeVRDriver::ParsePoseSubmitMode(std::string_view name) {
+    if (name == "frame")
+        return PoseSubmitMode::FRAME;
+    if (name == "thread")
+        return PoseSubmitMode::THREAD;
+    return PoseSubmitMode::IMMEDIATE;
+}
+
+std::string_view SlimeVRDriver::GetPoseSubmitModeName(PoseSubmitMode mode) {
+    switch (mode) {
+    case PoseSubmitMode::FRAME:
+        return "frame";
+    case PoseSubmitMode::THREAD:
+        return "thread";
+    case PoseSubmitMode::IMMEDIATE:
+    default:
+        return "immediate";
+    }
+}
+
+void SlimeVRDriver::PoseSubmitter::Start(PoseSubmitMode mode, float rate_hz, const DeviceTable& devices) {
+    Stop();
+    mode_ = mode;
+    if (mode_ == PoseSubmitMode::THREAD) {
+        if (!(rate_hz > 0.f)) {
+            logger_->Log("Invalid pose submit rate {}, submitting once per frame instead", rate_hz);
+            mode_ = PoseSubmitMode::FRAME;
+        } else {
+            exiting_ = false;
+            thread_ = std::make_unique<std::thread>(&PoseSubmitter::RunThread, this, rate_hz, std::cref(devices));
+        }
+    }
+    logger_->Log("Pose submission mode: {}", GetPoseSubmitModeName(mode_));
+}
+
+void SlimeVRDriver::PoseSubmitter::Stop() {
+    if (!thread_)
+        return;
+    exiting_ = true;
+    thread_->join();
+    thread_.reset();
+}
+
+void SlimeVRDriver::PoseSubmitter::RunFrame(const DeviceTable& devices) {
+    if (mode_ == PoseSubmitMode::FRAME)
+        SubmitPending(devices);
+
+    if (std::chrono::steady_clock::now() - last_logged_at_ >= std::chrono::seconds(60))
+        LogStats();
+}
+
+SlimeVRDriver::PoseSubmitStats SlimeVRDriver::PoseSubmitter::GetStats() const {
+    PoseSubmitStats stats;
+    stats.received = received_.load(std::memory_order_relaxed);
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SlimeVRDriver::PoseSubmitter::SubmitPending(const DeviceTable& devices) {
+    for (auto& device : devices.Get().devices) {
+        device->SubmitPendingPose();
+    }
+}
+
+void SlimeVRDriver::PoseSubmitter::RunThread(float rate_hz, const DeviceTable& devices) {
+    auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate_hz));
+    auto next_tick = std::chrono::steady_clock::now();
+    logger_->Log("Pose submission thread started at {:.1f} Hz", rate_hz);
+    while (!exiting_) {
+        devices.Quiesce(DeviceTable::Reader::POSE_SUBMITTER);
+        SubmitPending(devices);
+
+        next_tick += period;
+        auto now = std::chrono::steady_clock::now();
+        if (next_tick < now) {
+            // we fell behind (e.g. a slow SteamVR call), don't try to catch up with a burst
+            next_tick = now;
+        }
+        std::this_thread::sleep_until(next_tick);
+    }
+    devices.GoOffline(DeviceTable::Reader::POSE_SUBMITTER);
+    logger_->Log("Pose submission thread exiting");
+}
+
+void SlimeVRDriver::PoseSubmitter::LogStats() {
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - last_logged_at_).count();
+    PoseSubmitStats stats = GetStats();
+    uint64_t received = stats.received - last_logged_stats_.received;
+    uint64_t submitted = stats.submitted - last_logged_stats_.submitted;
+    uint64_t coalesced = stats.coalesced - last_logged_stats_.coalesced;
+    last_logged_stats_ = stats;
+    last_logged_at_ = now;
+
+    if (!received)
+        return;
+    logger_->Log(
+        "Pose submission ({}): {:.1f} poses/s received, {:.1f} poses/s submitted, {} coalesced ({:.1f}%)",
+        GetPoseSubmitModeName(mode_),
+        received / seconds,
+        submitted / seconds,
+        coalesced,
+        100.0 * coalesced / received);
+}
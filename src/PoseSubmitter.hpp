@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+#include "DeviceTable.hpp"
+#include "Logger.hpp"
+
+namespace SlimeVRDriver {
+
+enum class PoseSubmitMode {
+    // TrackedDevicePoseUpdated is called from the bridge thread for every received pose
+    IMMEDIATE,
+    // The newest pose of each device is submitted once per RunFrame
+    FRAME,
+    // The newest pose of each device is submitted from a dedicated thread at a fixed rate
+    THREAD,
+};
+
+/**
+ * Parses the poseSubmitMode setting.
+ *
+ * @param name "immediate", "frame" or "thread".
+ * @return The matching mode, IMMEDIATE for anything else.
+ */
+PoseSubmitMode ParsePoseSubmitMode(std::string_view name);
+
+std::string_view GetPoseSubmitModeName(PoseSubmitMode mode);
+
+struct PoseSubmitStats {
+    // poses handed over by devices
+    uint64_t received = 0;
+    // TrackedDevicePoseUpdated calls
+    uint64_t submitted = 0;
+    // poses replaced by a newer one before they were submitted
+    uint64_t coalesced = 0;
+};
+
+/**
+ * Decouples TrackedDevicePoseUpdated from the bridge IO thread.
+ *
+ * Devices keep their newest pose in a slot and flag it as pending. Depending on the mode, pending poses are
+ * pushed to SteamVR once per RunFrame or from a thread running at a fixed rate, so a burst of server frames
+ * collapses into a single SteamVR call per device and a slow SteamVR call no longer stalls socket reads.
+ */
+class PoseSubmitter {
+public:
+    PoseSubmitter(std::shared_ptr<Logger> logger)
+        : logger_(logger) { }
+    ~PoseSubmitter() {
+        Stop();
+    }
+
+    /**
+     * Sets the submission mode and, for THREAD, the submission rate. Starts the submission thread if needed.
+     *
+     * @param mode Submission mode.
+     * @param rate_hz Submission rate for THREAD mode.
+     * @param devices Device table to submit poses from.
+     */
+    void Start(PoseSubmitMode mode, float rate_hz, const DeviceTable& devices);
+
+    /**
+     * Stops the submission thread, if any. Blocks until it exited.
+     */
+    void Stop();
+
+    PoseSubmitMode GetMode() const {
+        return mode_;
+    }
+
+    /**
+     * Returns true if devices should call TrackedDevicePoseUpdated themselves.
+     */
+    bool IsImmediate() const {
+        return mode_ == PoseSubmitMode::IMMEDIATE;
+    }
+
+    /**
+     * Called from RunFrame. Submits pending poses in FRAME mode and periodically logs statistics.
+     *
+     * @param devices Device table to submit poses from.
+     */
+    void RunFrame(const DeviceTable& devices);
+
+    /**
+     * Records that a device stored a new pose.
+     *
+     * @param coalesced True if the previous pose of the device was never submitted.
+     */
+    void CountReceived(bool coalesced) {
+        received_.fetch_add(1, std::memory_order_relaxed);
+        if (coalesced)
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Records a TrackedDevicePoseUpdated call.
+     */
+    void CountSubmitted() {
+        submitted_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PoseSubmitStats GetStats() const;
+
+private:
+    void SubmitPending(const DeviceTable& devices);
+    void RunThread(float rate_hz, const DeviceTable& devices);
+    void LogStats();
+
+    std::shared_ptr<Logger> logger_;
+    PoseSubmitMode mode_ = PoseSubmitMode::IMMEDIATE;
+    std::atomic<bool> exiting_ = false;
+    std::unique_ptr<std::thread> thread_ = nullptr;
+
+    // the IO thread and the submitting thread update different counters
+    alignas(64) std::atomic<uint64_t> received_ = 0;
+    std::atomic<uint64_t> coalesced_ = 0;
+    alignas(64) std::atomic<uint64_t> submitted_ = 0;
+
+    PoseSubmitStats last_logged_stats_{};
+    std::chrono::steady_clock::time_point last_logged_at_ = std::chrono::steady_clock::now();
+};
+
+} // namespace SlimeVRDriver
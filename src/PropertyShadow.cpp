@@ -0,0 +1,76 @@
+#include "PropertyShadow.hpp"
+
+void SlimeVRDriver::PropertyShadow::SetBool(vr::ETrackedDeviceProperty prop, bool value) {
+    Entry* entry = Find(prop, vr::k_unBoolPropertyTag);
+    entry->is_pending = !entry->is_published || entry->published.as_bool != value;
+    entry->pending.as_bool = value;
+}
+
+void SlimeVRDriver::PropertyShadow::SetFloat(vr::ETrackedDeviceProperty prop, float value) {
+    Entry* entry = Find(prop, vr::k_unFloatPropertyTag);
+    entry->is_pending = !entry->is_published || entry->published.as_float != value;
+    entry->pending.as_float = value;
+}
+
+uint32_t SlimeVRDriver::PropertyShadow::Commit(vr::PropertyContainerHandle_t container, vr::IVRProperties* properties) {
+    if (container != container_) {
+        Reset();
+        container_ = container;
+    }
+
+    writes_.clear();
+    for (auto& entry : entries_) {
+        if (!entry.is_pending)
+            continue;
+        vr::PropertyWrite_t write{};
+        write.prop = entry.prop;
+        write.writeType = vr::PropertyWrite_Set;
+        write.pvBuffer = &entry.pending;
+        write.unBufferSize = entry.tag == vr::k_unBoolPropertyTag ? sizeof(bool) : sizeof(float);
+        write.unTag = entry.tag;
+        // only counts as written if SteamVR got to this entry and set the error
+        write.eError = vr::TrackedProp_NotYetAvailable;
+        writes_.push_back(write);
+    }
+    if (writes_.empty())
+        return 0;
+
+    if (!properties)
+        properties = vr::VRPropertiesRaw();
+    // e.g. an invalid container or a device that isn't ready yet, everything stays pending
+    if (properties->WritePropertyBatch(container, writes_.data(), static_cast<uint32_t>(writes_.size())) != vr::TrackedProp_Success)
+        return 0;
+
+    uint32_t written = 0;
+    for (size_t i = 0, write = 0; i < entries_.size(); i++) {
+        Entry& entry = entries_[i];
+        if (!entry.is_pending)
+            continue;
+        // failed writes stay pending and are retried on the next commit
+        if (writes_[write++].eError == vr::TrackedProp_Success) {
+            entry.published = entry.pending;
+            entry.is_published = true;
+            entry.is_pending = false;
+            written++;
+        }
+    }
+    return written;
+}
+
+void SlimeVRDriver::PropertyShadow::Reset() {
+    for (auto& entry : entries_) {
+        entry.is_pending = entry.is_pending || entry.is_published;
+        entry.is_published = false;
+    }
+}
+
+SlimeVRDriver::PropertyShadow::Entry* SlimeVRDriver::PropertyShadow::Find(vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t tag) {
+    for (auto& entry : entries_) {
+        if (entry.prop == prop && entry.tag == tag)
+            return &entry;
+    }
+    Entry& entry = entries_.emplace_back();
+    entry.prop = prop;
+    entry.tag = tag;
+    return &entry;
+}
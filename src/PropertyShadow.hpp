@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <openvr_driver.h>
+
+namespace SlimeVRDriver {
+
+/**
+ * Shadow copy of the properties a device has published to SteamVR.
+ *
+ * Setters only queue values that differ from what was last written, and Commit writes all queued values with a
+ * single WritePropertyBatch call, so repeated status messages carrying the same values cost no property traffic.
+ *
+ * Not thread safe, meant to be owned by the thread that handles the device's messages.
+ */
+class PropertyShadow {
+public:
+    /**
+     * Queues a bool property, if it differs from the published value.
+     */
+    void SetBool(vr::ETrackedDeviceProperty prop, bool value);
+
+    /**
+     * Queues a float property, if it differs from the published value.
+     */
+    void SetFloat(vr::ETrackedDeviceProperty prop, float value);
+
+    /**
+     * Writes the queued properties in one batch. Switching to another container forgets all published values, since
+     * a reactivated device starts with fresh properties.
+     *
+     * @param container Property container of the device.
+     * @param properties Property interface to write to, defaults to vr::VRPropertiesRaw().
+     * @return The number of properties written. Properties that failed, or all of them if the batch failed, stay
+     * queued for the next commit.
+     */
+    uint32_t Commit(vr::PropertyContainerHandle_t container, vr::IVRProperties* properties = nullptr);
+
+    /**
+     * Forgets all published values, so the next Commit writes every property again.
+     */
+    void Reset();
+
+private:
+    struct Entry {
+        vr::ETrackedDeviceProperty prop = vr::Prop_Invalid;
+        vr::PropertyTypeTag_t tag = 0;
+        // bool values are stored in the first byte, as WritePropertyBatch expects for bool properties
+        union {
+            bool as_bool;
+            float as_float;
+        } published{}, pending{};
+        bool is_published = false;
+        bool is_pending = false;
+    };
+
+    Entry* Find(vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t tag);
+
+    std::vector<Entry> entries_;
+    // reused between commits
+    std::vector<vr::PropertyWrite_t> writes_;
+    vr::PropertyContainerHandle_t container_ = vr::k_ulInvalidPropertyContainer;
+};
+
+} // namespace SlimeVRDriver
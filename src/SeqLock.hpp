@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace SlimeVRDriver {
+
+/**
+ * A slot holding a trivially copyable value of any size, shared between threads without a lock.
+ *
+ * Readers never block writers and never take a lock: they copy the value and retry if a write overlapped the copy,
+ * which only happens while a write is in progress. Writers are serialised among themselves by the sequence counter.
+ *
+ * The value is stored as an array of relaxed atomic words, so concurrent reads and writes are well defined and
+ * ThreadSanitizer-clean, unlike the usual memcpy-based seqlock. This replaces std::atomic<T> for large T, which
+ * isn't lock-free and falls back to libatomic's lock table.
+ *
+ * @param T Value type, must be trivially copyable.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock()
+        : SeqLock(T{}) { }
+    explicit SeqLock(const T& value) {
+        Store(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * Replaces the stored value.
+     *
+     * @param value New value.
+     */
+    void Store(const T& value) {
+        uint64_t words[kWords]{};
+        std::memcpy(words, &value, sizeof(T));
+
+        // an odd sequence marks a write in progress, it also keeps other writers out
+        uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        while ((sequence & 1) || !sequence_.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            if (sequence & 1) {
+                std::this_thread::yield();
+                sequence = sequence_.load(std::memory_order_relaxed);
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < kWords; i++) {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Returns a consistent copy of the stored value.
+     *
+     * @return The last stored value.
+     */
+    T Load() const {
+        uint64_t words[kWords];
+        while (true) {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (size_t i = 0; i < kWords; i++) {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before)
+                break;
+        }
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /**
+     * Returns the number of completed writes.
+     */
+    uint64_t GetVersion() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> sequence_ = 0;
+    std::array<std::atomic<uint64_t>, kWords> words_{};
+};
+
+} // namespace SlimeVRDriver
@@ -0,0 +1,136 @@
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    int64_t start_ns;
+    int64_t duration_ns;
+};
+
+// Written only by its thread. The fields are relaxed atomics so that reading while the thread overwrites a slot is
+// well defined, torn slots are detected through count.
+struct ThreadBuffer {
+    struct Slot {
+        std::atomic<const char*> name;
+        std::atomic<int64_t> start_ns;
+        std::atomic<int64_t> duration_ns;
+    };
+
+    uint32_t tid = 0;
+    std::atomic<const char*> name = nullptr;
+    std::unique_ptr<Slot[]> slots = std::make_unique<Slot[]>(SlimeVRDriver::Trace::kEventsPerThread);
+    std::atomic<uint64_t> count = 0;
+};
+
+// buffers outlive their threads, so spans of threads that exited are still written
+std::mutex buffers_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+const auto epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer& GetThreadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        buffer->tid = static_cast<uint32_t>(buffers.size() + 1);
+        buffers.push_back(buffer);
+        return buffer;
+    }();
+    return *buffer;
+}
+
+std::vector<TraceEvent> CopyEvents(const ThreadBuffer& buffer) {
+    constexpr uint64_t capacity = SlimeVRDriver::Trace::kEventsPerThread;
+    uint64_t end = buffer.count.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+    std::vector<TraceEvent> events;
+    events.reserve(end - begin);
+    for (uint64_t i = begin; i < end; i++) {
+        auto& slot = buffer.slots[i % capacity];
+        events.push_back({
+            slot.name.load(std::memory_order_relaxed),
+            slot.start_ns.load(std::memory_order_relaxed),
+            slot.duration_ns.load(std::memory_order_relaxed),
+        });
+    }
+
+    // the slots of spans recorded meanwhile, and the one being recorded now, may have been overwritten
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t written = buffer.count.load(std::memory_order_relaxed) + 1;
+    if (written > capacity && written - capacity > begin) {
+        events.erase(events.begin(), events.begin() + std::min(written - capacity - begin, events.size()));
+    }
+    return events;
+}
+
+} // namespace
+
+void SlimeVRDriver::Trace::SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void SlimeVRDriver::Trace::SetThreadName(const char* name) {
+    if (!IsEnabled())
+        return;
+    const char* expected = nullptr;
+    GetThreadBuffer().name.compare_exchange_strong(expected, name, std::memory_order_relaxed);
+}
+
+void SlimeVRDriver::Trace::Record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    uint64_t index = buffer.count.load(std::memory_order_relaxed);
+    auto& slot = buffer.slots[index % kEventsPerThread];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count(), std::memory_order_relaxed);
+    slot.duration_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(), std::memory_order_relaxed);
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+std::string SlimeVRDriver::Trace::ToChromeJson() {
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        threads = buffers;
+    }
+
+    std::string json = R"({"displayTimeUnit":"ms","traceEvents":[)";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first)
+            json += ',';
+        first = false;
+    };
+    for (const auto& thread : threads) {
+        if (const char* name = thread->name.load(std::memory_order_relaxed)) {
+            separator();
+            std::format_to(std::back_inserter(json), R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})", thread->tid, name);
+        }
+        for (const auto& event : CopyEvents(*thread)) {
+            separator();
+            std::format_to(
+                std::back_inserter(json),
+                R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                event.name,
+                thread->tid,
+                event.start_ns / 1000.0,
+                event.duration_ns / 1000.0);
+        }
+    }
+    json += "]}";
+    return json;
+}
+
+bool SlimeVRDriver::Trace::WriteChromeTrace(const std::filesystem::path& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    file << ToChromeJson();
+    return static_cast<bool>(file);
+}
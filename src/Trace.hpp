@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace SlimeVRDriver {
+
+/**
+ * Opt-in timeline of what the driver threads are doing, written as a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * Every thread records completed spans into its own ring of the last kEventsPerThread spans without locking or
+ * allocating, and the rings are only read when the trace is written. While disabled, a span costs one relaxed load.
+ */
+class Trace {
+public:
+    // about 1.5MB for every thread that records while enabled
+    static constexpr size_t kEventsPerThread = 1 << 16;
+
+    static void SetEnabled(bool enabled);
+
+    static bool IsEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Names the calling thread in the trace, only the first name sticks.
+     *
+     * @param name A string literal.
+     */
+    static void SetThreadName(const char* name);
+
+    /**
+     * Records a span of the calling thread.
+     *
+     * @param name A string literal.
+     */
+    static void Record(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+
+    /**
+     * Returns the recorded spans of all threads as Chrome trace JSON. Spans may be recorded concurrently, those
+     * overwritten while copying are left out.
+     */
+    static std::string ToChromeJson();
+
+    /**
+     * Writes ToChromeJson to a file.
+     *
+     * @return False if the file couldn't be written.
+     */
+    static bool WriteChromeTrace(const std::filesystem::path& path);
+
+private:
+    static inline std::atomic<bool> enabled_ = false;
+};
+
+/**
+ * Records the lifetime of the scope as a span if tracing is enabled when it's entered.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_(name) {
+        if (Trace::IsEnabled())
+            start_ = std::chrono::steady_clock::now();
+    }
+
+    ~TraceScope() {
+        if (start_ != std::chrono::steady_clock::time_point{})
+            Trace::Record(name_, start_, std::chrono::steady_clock::now());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    std::chrono::steady_clock::time_point start_{};
+};
+
+} // namespace SlimeVRDriver
+
+#define SLIMEVR_TRACE_CONCAT_(a, b) a##b
+#define SLIMEVR_TRACE_CONCAT(a, b) SLIMEVR_TRACE_CONCAT_(a, b)
+// Traces the rest of the enclosing scope under a string literal name
+#define TRACE_SCOPE(name) ::SlimeVRDriver::TraceScope SLIMEVR_TRACE_CONCAT(trace_scope_, __LINE__)(name)
@@ -5,28 +5,24 @@ SlimeVRDriver::TrackerDevice::TrackerDevice(std::string serial, int device_id, T
     : serial_(serial)
     , device_id_(device_id)
     , tracker_role_(tracker_role)
-    , last_pose_(MakeDefaultPose())
-    , last_pose_atomic_(MakeDefaultPose()) { }
+    , last_pose_(MakeDefaultPose()) { }
 
 std::string SlimeVRDriver::TrackerDevice::GetSerial() {
     return serial_;
 }
 
-void SlimeVRDriver::TrackerDevice::Update() {
+void SlimeVRDriver::TrackerDevice::Update(const EventIndex& events) {
     if (device_index_ == vr::k_unTrackedDeviceIndexInvalid)
         return;
 
-    // Check if this device was asked to be identified
-    auto& events = GetDriver()->GetOpenVREvents();
-    for (const auto& event : events) {
-        // Note here, event.trackedDeviceIndex does not necessarily equal device_index_, not sure why, but the component handle will match so we can just use that instead
-        // if (event.trackedDeviceIndex == device_index_) {
-        if (event.eventType == vr::EVREventType::VREvent_Input_HapticVibration) {
-            if (event.data.hapticVibration.componentHandle == haptic_component_) {
-                did_vibrate_ = true;
-            }
+    // Check if this device was asked to vibrate, e.g. to be identified
+    // Note here, event.trackedDeviceIndex does not necessarily equal device_index_, not sure why, but the component handle will match so we can just use that instead
+    if (haptic_component_ != vr::k_ulInvalidInputComponentHandle) {
+        for (const auto& entry : events.ForHapticComponent(haptic_component_)) {
+            did_vibrate_ = true;
+            // Update runs right after the frame's events were polled, forward without waiting for anything else
+            SendHapticFeedback(entry.event->data.hapticVibration);
         }
-        //}
     }
 
     // Check if we need to keep vibrating
@@ -39,21 +35,30 @@ void SlimeVRDriver::TrackerDevice::Update() {
     }
 }
 
-void SlimeVRDriver::TrackerDevice::PositionMessage(messages::Position& position) {
+void SlimeVRDriver::TrackerDevice::SendHapticFeedback(const vr::VREvent_HapticVibration_t& vibration) {
+    // HapticFeedback was added with protocol version 3, like PingPong, older servers don't know it
+    if (GetDriver()->GetServerProtocolVersion() < 3)
+        return;
+    messages::ProtobufMessage message;
+    messages::HapticFeedback* haptic = message.mutable_haptic_feedback();
+    haptic->set_tracker_id(device_id_);
+    haptic->set_duration_seconds(vibration.fDurationSeconds);
+    haptic->set_frequency(vibration.fFrequency);
+    haptic->set_amplitude(vibration.fAmplitude);
+    GetDriver()->SendBridgeMessage(message);
+}
+
+void SlimeVRDriver::TrackerDevice::PositionMessage(messages::Position& position, std::chrono::steady_clock::time_point received_at) {
     if (device_index_ == vr::k_unTrackedDeviceIndexInvalid)
         return;
 
-#ifdef _DEBUG
-#define CHECK_CLASSIFICATION(D)                                                                    \
-    if (auto classification = std::fpclassify((D)); classification == FP_NAN) {                    \
-        logger_->Log("Uh oh! fpclassify(" #D ") returned FP_NAN for {}: {}, zeroing", D, serial_); \
-        D = 0.0;                                                                                   \
+#define CHECK_CLASSIFICATION(D)                                                                      \
+    if (auto classification = std::fpclassify((D)); classification == FP_NAN) {                      \
+        logger_->Debug("Uh oh! fpclassify(" #D ") returned FP_NAN for {}: {}, zeroing", D, serial_); \
+        D = 0.0;                                                                                     \
     }
-#else
-#define CHECK_CLASSIFICATION(D)                                               \
-    if (auto classification = std::fpclassify((D)); classification == FP_NAN) \
-        D = 0.0;
-#endif
+
+    auto now = received_at;
 
     // Setup pose for this frame
     auto pose = last_pose_;
@@ -76,46 +81,77 @@ void SlimeVRDriver::TrackerDevice::PositionMessage(messages::Position& position)
     CHECK_CLASSIFICATION(pose.qRotation.y);
     CHECK_CLASSIFICATION(pose.qRotation.z);
 
-    if (position.has_vx()) {
-        pose.vecVelocity[0] = position.vx();
-        pose.vecVelocity[1] = position.vy();
-        pose.vecVelocity[2] = position.vz();
-        CHECK_CLASSIFICATION(pose.vecVelocity[0]);
-        CHECK_CLASSIFICATION(pose.vecVelocity[1]);
-        CHECK_CLASSIFICATION(pose.vecVelocity[2]);
-    } else { // If velocity isn't being sent, don't keep stale values
-        pose.vecVelocity[0] = 0.0f;
-        pose.vecVelocity[1] = 0.0f;
-        pose.vecVelocity[2] = 0.0f;
-    }
-
-    auto current_universe = GetDriver()->GetCurrentUniverse();
-    if (current_universe.has_value()) {
-        auto trans = current_universe.value();
-
-        // TODO: set this once, somewhere?
-        pose.vecWorldFromDriverTranslation[0] = -trans.translation.v[0];
-        pose.vecWorldFromDriverTranslation[1] = -trans.translation.v[1];
-        pose.vecWorldFromDriverTranslation[2] = -trans.translation.v[2];
-        CHECK_CLASSIFICATION(pose.vecWorldFromDriverTranslation[0]);
-        CHECK_CLASSIFICATION(pose.vecWorldFromDriverTranslation[1]);
-        CHECK_CLASSIFICATION(pose.vecWorldFromDriverTranslation[2]);
-
-        pose.qWorldFromDriverRotation.w = cos(trans.yaw / 2);
-        pose.qWorldFromDriverRotation.x = 0.0;
-        pose.qWorldFromDriverRotation.y = sin(trans.yaw / 2);
-        pose.qWorldFromDriverRotation.z = 0.0;
-        CHECK_CLASSIFICATION(pose.qWorldFromDriverRotation.w);
-        CHECK_CLASSIFICATION(pose.qWorldFromDriverRotation.y);
+    double dt = std::chrono::duration<double>(now - last_pose_received_at_).count();
+
+    if (!pose_filter_.IsEnabled() && filter_params_set_.load(std::memory_order_acquire))
+        pose_filter_.Enable(filter_position_params_, filter_rotation_params_);
+    pose_filter_.Filter(pose, dt);
+
+    // Motion sent by the server is in the same driver space as the position, SteamVR moves all of it into the
+    // universe with the pose's world from driver transform.
+    auto set_checked = [&](double (&out)[3], double x, double y, double z) {
+        out[0] = x;
+        out[1] = y;
+        out[2] = z;
+        for (double& v : out) {
+            CHECK_CLASSIFICATION(v);
+        }
+    };
+
+    // Velocities the server doesn't send are derived from the recent poses, so SteamVR can predict the pose through
+    // its render pipeline and the submission stage can extrapolate it.
+    double derived_velocity[3] = {};
+    double derived_angular_velocity[3] = {};
+    bool derive = derive_velocity_ || extrapolation_horizon_ > 0.0;
+    if (derive && !(position.has_vx() && position.has_angular_vx())) {
+        velocity_estimator_.Push(pose, now);
+        velocity_estimator_.Estimate(derived_velocity, derived_angular_velocity);
+    }
+
+    // If a value isn't being sent, don't keep stale values
+    if (position.has_vx())
+        set_checked(pose.vecVelocity, position.vx(), position.vy(), position.vz());
+    else if (derive_velocity_)
+        set_checked(pose.vecVelocity, derived_velocity[0], derived_velocity[1], derived_velocity[2]);
+    else
+        set_checked(pose.vecVelocity, 0.0, 0.0, 0.0);
+
+    if (position.has_angular_vx())
+        set_checked(pose.vecAngularVelocity, position.angular_vx(), position.angular_vy(), position.angular_vz());
+    else if (derive)
+        set_checked(pose.vecAngularVelocity, derived_angular_velocity[0], derived_angular_velocity[1], derived_angular_velocity[2]);
+    else
+        set_checked(pose.vecAngularVelocity, 0.0, 0.0, 0.0);
+
+    if (position.has_ax())
+        set_checked(pose.vecAcceleration, position.ax(), position.ay(), position.az());
+    else
+        set_checked(pose.vecAcceleration, 0.0, 0.0, 0.0);
+
+    if (position.has_angular_ax())
+        set_checked(pose.vecAngularAcceleration, position.angular_ax(), position.angular_ay(), position.angular_az());
+    else
+        set_checked(pose.vecAngularAcceleration, 0.0, 0.0, 0.0);
+
+    // the transform only changes with the universe, refresh our copy when a new one was published
+    if (GetDriver()->GetUniverseGeneration() != universe_.generation)
+        universe_ = GetDriver()->GetUniverseTransform();
+    if (universe_.generation) {
+        for (int i = 0; i < 3; i++)
+            pose.vecWorldFromDriverTranslation[i] = universe_.world_from_driver_translation[i];
+        pose.qWorldFromDriverRotation = universe_.world_from_driver_rotation;
     }
 
     pose.deviceIsConnected = true;
     pose.poseIsValid = true;
     pose.result = vr::ETrackingResult::TrackingResult_Running_OK;
 
+    if (resample_delay_.count() > 0)
+        pose_history_.Push(TimedPose{ pose, now });
+
     // Notify SteamVR that pose was updated
-    last_pose_atomic_ = (last_pose_ = pose);
-    GetDriver()->GetDriverHost()->TrackedDevicePoseUpdated(device_index_, pose, sizeof(vr::DriverPose_t));
+    last_pose_received_at_ = now;
+    SubmitPose(pose, now);
 }
 
 void SlimeVRDriver::TrackerDevice::BatteryMessage(messages::Battery& battery) {
@@ -125,22 +161,14 @@ void SlimeVRDriver::TrackerDevice::BatteryMessage(messages::Battery& battery) {
     // Get the properties handle
     auto props = GetDriver()->GetProperties()->TrackedDeviceToPropertyContainer(this->device_index_);
 
-    vr::ETrackedPropertyError err;
-
-    // Set that the tracker reports battery level in case it has not already been set to true
     // It's a given that the tracker supports reporting battery life because otherwise a BatteryMessage would not be received
-    if (vr::VRProperties()->GetBoolProperty(props, vr::Prop_DeviceProvidesBatteryStatus_Bool, &err) != true) {
-        vr::VRProperties()->SetBoolProperty(props, vr::Prop_DeviceProvidesBatteryStatus_Bool, true);
-    }
-
-    if (battery.is_charging()) {
-        vr::VRProperties()->SetBoolProperty(props, vr::Prop_DeviceIsCharging_Bool, true);
-    } else {
-        vr::VRProperties()->SetBoolProperty(props, vr::Prop_DeviceIsCharging_Bool, false);
-    }
-
+    properties_.SetBool(vr::Prop_DeviceProvidesBatteryStatus_Bool, true);
+    properties_.SetBool(vr::Prop_DeviceIsCharging_Bool, battery.is_charging());
     // Set the battery Level; 0 = 0%, 1 = 100%
-    vr::VRProperties()->SetFloatProperty(props, vr::Prop_DeviceBatteryPercentage_Float, battery.battery_level());
+    properties_.SetFloat(vr::Prop_DeviceBatteryPercentage_Float, battery.battery_level());
+
+    // Only values that changed since the last message are written
+    properties_.Commit(props);
 }
 
 void SlimeVRDriver::TrackerDevice::StatusMessage(messages::TrackerStatus& status) {
@@ -167,8 +195,96 @@ void SlimeVRDriver::TrackerDevice::StatusMessage(messages::TrackerStatus& status
 
     // TODO: send position/rotation of 0 instead of last pose?
 
-    last_pose_atomic_ = (last_pose_ = pose);
-    GetDriver()->GetDriverHost()->TrackedDevicePoseUpdated(device_index_, pose, sizeof(vr::DriverPose_t));
+    SubmitPose(pose, last_pose_received_at_);
+}
+
+void SlimeVRDriver::TrackerDevice::SubmitPose(const vr::DriverPose_t& pose, std::chrono::steady_clock::time_point received_at) {
+    last_pose_slot_.Store(TimedPose{ (last_pose_ = pose), received_at });
+
+    auto& submitter = GetDriver()->GetPoseSubmitter();
+    if (submitter.IsImmediate()) {
+        submitter.CountReceived(false);
+        {
+            TRACE_SCOPE("TrackedDevicePoseUpdated");
+            GetDriver()->GetDriverHost()->TrackedDevicePoseUpdated(device_index_, pose, sizeof(vr::DriverPose_t));
+        }
+        submitter.CountSubmitted();
+        RecordSubmitLatency(received_at);
+        return;
+    }
+
+    // The submission stage picks the pose up from last_pose_slot_
+    bool coalesced = pose_pending_.exchange(true, std::memory_order_acq_rel);
+    submitter.CountReceived(coalesced);
+}
+
+bool SlimeVRDriver::TrackerDevice::SubmitPendingPose() {
+    if (device_index_ == vr::k_unTrackedDeviceIndexInvalid)
+        return false;
+    bool pending = pose_pending_.exchange(false, std::memory_order_acq_rel);
+    if (resample_delay_.count() > 0)
+        return SubmitResampledPose(pending);
+    if (!pending && (extrapolation_horizon_ <= 0.0 || pose_frozen_))
+        return false;
+
+    TimedPose timed_pose = last_pose_slot_.Load();
+    vr::DriverPose_t pose = timed_pose.pose;
+    if (extrapolation_horizon_ > 0.0 && pose.poseIsValid) {
+        double age = std::chrono::duration<double>(std::chrono::steady_clock::now() - timed_pose.time).count();
+        // SteamVR keeps extrapolating the last submitted pose by itself until it reaches the horizon
+        if (!pending && age <= extrapolation_horizon_)
+            return false;
+        pose = ExtrapolatePoseForSubmit(pose, age, extrapolation_horizon_);
+        pose_frozen_ = age > extrapolation_horizon_;
+    } else if (!pending) {
+        return false;
+    }
+
+    {
+        TRACE_SCOPE("TrackedDevicePoseUpdated");
+        GetDriver()->GetDriverHost()->TrackedDevicePoseUpdated(device_index_, pose, sizeof(vr::DriverPose_t));
+    }
+    GetDriver()->GetPoseSubmitter().CountSubmitted();
+    RecordSubmitLatency(timed_pose.time);
+    return true;
+}
+
+bool SlimeVRDriver::TrackerDevice::SubmitResampledPose(bool pending) {
+    // once the delayed time passed the newest pose there is nothing left to interpolate until a new one arrives
+    if (!pending && resample_caught_up_)
+        return false;
+
+    // tracking state comes from the latest message, which may be a status change without a pose
+    vr::DriverPose_t pose = last_pose_slot_.Load().pose;
+    TimedPose sample;
+    auto result = pose_history_.Sample(std::chrono::steady_clock::now() - resample_delay_, sample);
+    resample_caught_up_ = result == PoseHistory::SampleResult::AFTER_NEWEST || result == PoseHistory::SampleResult::EMPTY;
+    if (result != PoseHistory::SampleResult::EMPTY && pose.poseIsValid) {
+        for (int i = 0; i < 3; i++) {
+            pose.vecPosition[i] = sample.pose.vecPosition[i];
+            pose.vecVelocity[i] = sample.pose.vecVelocity[i];
+            pose.vecAngularVelocity[i] = sample.pose.vecAngularVelocity[i];
+        }
+        pose.qRotation = sample.pose.qRotation;
+    }
+
+    {
+        TRACE_SCOPE("TrackedDevicePoseUpdated");
+        GetDriver()->GetDriverHost()->TrackedDevicePoseUpdated(device_index_, pose, sizeof(vr::DriverPose_t));
+    }
+    GetDriver()->GetPoseSubmitter().CountSubmitted();
+    // the resampled pose is as old as the time it was sampled at, which includes the resampling delay
+    if (result != PoseHistory::SampleResult::EMPTY)
+        RecordSubmitLatency(sample.time);
+    return true;
+}
+
+void SlimeVRDriver::TrackerDevice::RecordSubmitLatency(std::chrono::steady_clock::time_point received_at) {
+    // status changes and extrapolation submit the same pose again, only its first submission counts
+    if (received_at <= latency_recorded_for_)
+        return;
+    latency_recorded_for_ = received_at;
+    GetDriver()->GetReadToSubmitLatency().Record(std::chrono::steady_clock::now() - received_at);
 }
 
 DeviceType SlimeVRDriver::TrackerDevice::GetDeviceType() {
@@ -180,11 +296,9 @@ vr::TrackedDeviceIndex_t SlimeVRDriver::TrackerDevice::GetDeviceIndex() {
 }
 
 vr::EVRInitError SlimeVRDriver::TrackerDevice::Activate(uint32_t unObjectId) {
-    device_index_ = unObjectId;
-
     logger_->Log("Activating tracker {}", serial_);
 
-    auto props = GetDriver()->GetProperties()->TrackedDeviceToPropertyContainer(device_index_);
+    auto props = GetDriver()->GetProperties()->TrackedDeviceToPropertyContainer(unObjectId);
 
     GetDriver()->GetProperties()->SetStringProperty(props, vr::Prop_ManufacturerName_String, "SlimeVR");
     GetDriver()->GetProperties()->SetStringProperty(props, vr::Prop_ModelNumber_String, "SlimeVR Virtual Tracker");
@@ -197,15 +311,80 @@ vr::EVRInitError SlimeVRDriver::TrackerDevice::Activate(uint32_t unObjectId) {
     std::string input_profile_path = emulate_vives ? "{htc}/input/vive_tracker_profile.json" : "{slimevr}/input/slimevr_tracker_profile.json";
     GetDriver()->GetProperties()->SetStringProperty(props, vr::Prop_InputProfilePath_String, input_profile_path.c_str());
 
+    // Lets applications vibrate the tracker, vibrations are forwarded to the server. Hosts other than vrserver, like the
+    // fake driver context of the tests, may not provide an input interface.
+    if (auto* input = GetDriver()->GetInput()) {
+        auto input_error = input->CreateHapticComponent(props, "/output/haptic", &haptic_component_);
+        if (input_error != vr::VRInputError_None) {
+            logger_->Log("Failed to create haptic component for {}: error {}", serial_, static_cast<int>(input_error));
+            haptic_component_ = vr::k_ulInvalidInputComponentHandle;
+        }
+    }
+
+    derive_velocity_ = vr::VRSettings()->GetBool("driver_slimevr", "poseDeriveVelocity");
+
+    // Extrapolation and resampling are applied by the pose submission stage, poses submitted immediately are never stale
+    if (!GetDriver()->GetPoseSubmitter().IsImmediate()) {
+        float resample_delay_ms = vr::VRSettings()->GetFloat("driver_slimevr", "poseResampleDelayMs");
+        if (resample_delay_ms > 0.f) {
+            // the history has to reach back past the delay
+            resample_delay_ms = std::min(resample_delay_ms, kMaxResampleDelayMs);
+            resample_delay_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::milli>(resample_delay_ms));
+            logger_->Log("Resampling poses of {} with a {:.1f}ms delay", serial_, resample_delay_ms);
+        } else if (vr::VRSettings()->GetBool("driver_slimevr", "poseExtrapolation")) {
+            extrapolation_horizon_ = std::max(vr::VRSettings()->GetFloat("driver_slimevr", "poseExtrapolationMaxMs"), 0.f) / 1000.0;
+        }
+    }
+
+    if (GetRoleBoolSetting("poseFilter")) {
+        filter_position_params_ = {
+            GetRoleFloatSetting("poseFilterMinCutoff"),
+            GetRoleFloatSetting("poseFilterBeta"),
+            GetRoleFloatSetting("poseFilterDerivativeCutoff"),
+        };
+        filter_rotation_params_ = {
+            GetRoleFloatSetting("poseFilterRotationMinCutoff"),
+            GetRoleFloatSetting("poseFilterRotationBeta"),
+            GetRoleFloatSetting("poseFilterDerivativeCutoff"),
+        };
+        filter_params_set_.store(true, std::memory_order_release);
+        logger_->Log(
+            "Pose filter enabled for {}: position min cutoff {} Hz, beta {}; rotation min cutoff {} Hz, beta {}",
+            serial_,
+            filter_position_params_.min_cutoff,
+            filter_position_params_.beta,
+            filter_rotation_params_.min_cutoff,
+            filter_rotation_params_.beta);
+    }
+
     // Doesn't apply until restart of SteamVR
     auto role = GetViveRole(tracker_role_);
     if (role != "") {
         vr::VRSettings()->SetString(vr::k_pch_Trackers_Section, ("/devices/slimevr/" + serial_).c_str(), role.c_str());
     }
 
+    // Messages are ignored until the index is set, so the IO thread only sees the settings read above once complete
+    device_index_ = unObjectId;
+
     return vr::EVRInitError::VRInitError_None;
 }
 
+float SlimeVRDriver::TrackerDevice::GetRoleFloatSetting(const std::string& key) {
+    vr::EVRSettingsError error = vr::VRSettingsError_None;
+    float value = vr::VRSettings()->GetFloat("driver_slimevr", (key + "_" + GetRoleName(tracker_role_)).c_str(), &error);
+    if (error == vr::VRSettingsError_None)
+        return value;
+    return vr::VRSettings()->GetFloat("driver_slimevr", key.c_str());
+}
+
+bool SlimeVRDriver::TrackerDevice::GetRoleBoolSetting(const std::string& key) {
+    vr::EVRSettingsError error = vr::VRSettingsError_None;
+    bool value = vr::VRSettings()->GetBool("driver_slimevr", (key + "_" + GetRoleName(tracker_role_)).c_str(), &error);
+    if (error == vr::VRSettingsError_None)
+        return value;
+    return vr::VRSettings()->GetBool("driver_slimevr", key.c_str());
+}
+
 void SlimeVRDriver::TrackerDevice::Deactivate() {
     device_index_ = vr::k_unTrackedDeviceIndexInvalid;
 }
@@ -218,13 +397,17 @@ void* SlimeVRDriver::TrackerDevice::GetComponent(const char* pchComponentNameAnd
 }
 
 void SlimeVRDriver::TrackerDevice::DebugRequest(const char* pchRequest, char* pchResponseBuffer, uint32_t unResponseBufferSize) {
-    if (unResponseBufferSize >= 1) {
-        pchResponseBuffer[0] = 0;
-    }
+    if (unResponseBufferSize < 1)
+        return;
+    // there is no driver-wide entry point for debug requests, every device answers them
+    std::string response = GetDriver()->DebugRequest(pchRequest);
+    size_t length = std::min<size_t>(response.size(), unResponseBufferSize - 1);
+    response.copy(pchResponseBuffer, length);
+    pchResponseBuffer[length] = 0;
 }
 
 vr::DriverPose_t SlimeVRDriver::TrackerDevice::GetPose() {
-    return last_pose_atomic_;
+    return last_pose_slot_.Load().pose;
 }
 
 int SlimeVRDriver::TrackerDevice::GetDeviceId() {
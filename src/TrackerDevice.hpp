@@ -10,7 +10,14 @@
 #include <IVRDevice.hpp>
 
 #include "Logger.hpp"
+#include "PoseFilter.hpp"
+#include "PoseHistory.hpp"
+#include "PoseMath.hpp"
+#include "PropertyShadow.hpp"
+#include "SeqLock.hpp"
+#include "Trace.hpp"
 #include "TrackerRole.hpp"
+#include "VelocityEstimator.hpp"
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -25,14 +32,15 @@ public:
 
     // Inherited via IVRDevice
     virtual std::string GetSerial() override;
-    virtual void Update() override;
+    virtual void Update(const EventIndex& events) override;
     virtual vr::TrackedDeviceIndex_t GetDeviceIndex() override;
     virtual DeviceType GetDeviceType() override;
     virtual int GetDeviceId() override;
     virtual void SetDeviceId(int device_id) override;
-    virtual void PositionMessage(messages::Position& position) override;
+    virtual void PositionMessage(messages::Position& position, std::chrono::steady_clock::time_point received_at) override;
     virtual void StatusMessage(messages::TrackerStatus& status) override;
     virtual void BatteryMessage(messages::Battery& battery) override;
+    virtual bool SubmitPendingPose() override;
 
     // Inherited via ITrackedDeviceServerDriver
     virtual vr::EVRInitError Activate(uint32_t unObjectId) override;
@@ -43,6 +51,36 @@ public:
     virtual vr::DriverPose_t GetPose() override;
 
 private:
+    /**
+     * Stores a new pose and passes it to SteamVR, either right away or through the pose submission stage.
+     */
+    void SubmitPose(const vr::DriverPose_t& pose, std::chrono::steady_clock::time_point received_at);
+
+    /**
+     * Submits the pose history resampled at the current time minus the resample delay.
+     *
+     * @param pending True if a message arrived since the last submission.
+     * @return True if a pose was submitted.
+     */
+    bool SubmitResampledPose(bool pending);
+
+    /**
+     * Records the latency of a pose passed to SteamVR, the first time a pose received at that time is submitted.
+     */
+    void RecordSubmitLatency(std::chrono::steady_clock::time_point received_at);
+
+    /**
+     * Sends a haptic vibration requested by SteamVR to the server, if its protocol version has HapticFeedback.
+     */
+    void SendHapticFeedback(const vr::VREvent_HapticVibration_t& vibration);
+
+    /**
+     * Reads a driver_slimevr setting that can be overridden for this tracker's role by appending the role name to
+     * the key, e.g. poseFilterBeta_LEFT_FOOT.
+     */
+    float GetRoleFloatSetting(const std::string& key);
+    bool GetRoleBoolSetting(const std::string& key);
+
     std::shared_ptr<VRLogger> logger_ = std::make_shared<VRLogger>();
 
     std::atomic<vr::TrackedDeviceIndex_t> device_index_ = vr::k_unTrackedDeviceIndexInvalid;
@@ -52,12 +90,43 @@ private:
     TrackerRole tracker_role_;
 
     vr::DriverPose_t last_pose_ = IVRDevice::MakeDefaultPose();
-    std::atomic<vr::DriverPose_t> last_pose_atomic_ = IVRDevice::MakeDefaultPose();
+    std::chrono::steady_clock::time_point last_pose_received_at_{};
+    UniverseTransform universe_{};
+    SeqLock<TimedPose> last_pose_slot_{ TimedPose{ IVRDevice::MakeDefaultPose(), {} } };
+    // set when last_pose_slot_ holds a pose the submission stage hasn't passed to SteamVR yet
+    std::atomic<bool> pose_pending_ = false;
+    // receive time of the last pose counted in the read to submit latency, owned by the submitting thread
+    std::chrono::steady_clock::time_point latency_recorded_for_{};
+
+    // filter parameters are read in Activate and picked up by the IO thread once filter_params_set_ is set
+    OneEuroParams filter_position_params_;
+    OneEuroParams filter_rotation_params_;
+    std::atomic<bool> filter_params_set_ = false;
+    PoseFilter pose_filter_;
+
+    // velocities are derived from recent poses when the server doesn't send them
+    bool derive_velocity_ = false;
+    VelocityEstimator velocity_estimator_;
+
+    // properties written from the IO thread
+    PropertyShadow properties_;
+
+    // poses are resampled this far in the past, 0 if resampling is disabled
+    static constexpr float kMaxResampleDelayMs = 100.f;
+    std::chrono::steady_clock::duration resample_delay_{ 0 };
+    PoseHistory pose_history_;
+    // set by the submission stage once it submitted the newest pose in the history
+    bool resample_caught_up_ = false;
+
+    // how far poses may be extrapolated past their receive time in seconds, 0 if extrapolation is disabled
+    double extrapolation_horizon_ = 0.0;
+    // set by the submission stage once the last pose was frozen at the extrapolation horizon
+    bool pose_frozen_ = false;
 
     bool did_vibrate_ = false;
     float vibrate_anim_state_ = 0.f;
 
-    vr::VRInputComponentHandle_t haptic_component_ = 0;
+    vr::VRInputComponentHandle_t haptic_component_ = vr::k_ulInvalidInputComponentHandle;
     vr::VRInputComponentHandle_t system_click_component_ = 0;
     vr::VRInputComponentHandle_t system_touch_component_ = 0;
 };
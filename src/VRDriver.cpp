@@ -10,6 +10,10 @@ vr::EVRInitError SlimeVRDriver::VRDriver::Init(vr::IVRDriverContext* pDriverCont
     if (vr::EVRInitError init_error = vr::InitServerDriverContext(pDriverContext); init_error != vr::EVRInitError::VRInitError_None) {
         return init_error;
     }
+    char log_level[16]{};
+    vr::VRSettings()->GetString(settings_key_.c_str(), "logLevel", log_level, sizeof(log_level));
+    Logger::SetLevel(ParseLogLevel(log_level));
+    AsyncLogQueue::ForDriverLog().Start();
 
     logger_->Log("Activating SlimeVR Driver...");
 
@@ -22,12 +26,42 @@ vr::EVRInitError SlimeVRDriver::VRDriver::Init(vr::IVRDriverContext* pDriverCont
         logger_->Log("Error getting VR Config path, continuing (error code {})", std::to_string(e.error()));
     }
 
+    char submit_mode[32]{};
+    vr::VRSettings()->GetString(settings_key_.c_str(), "poseSubmitMode", submit_mode, sizeof(submit_mode));
+    float submit_rate = vr::VRSettings()->GetFloat(settings_key_.c_str(), "poseSubmitRate");
+    pose_submitter_.Start(ParsePoseSubmitMode(submit_mode), submit_rate, devices_);
+
+    auto log_rate_limit = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(vr::VRSettings()->GetFloat(settings_key_.c_str(), "logRateLimitSeconds")));
+    logger_->SetRateLimitInterval(log_rate_limit);
+
+    if (vr::VRSettings()->GetBool(settings_key_.c_str(), "traceEnabled")) {
+        char trace_file[1024]{};
+        vr::VRSettings()->GetString(settings_key_.c_str(), "traceFile", trace_file, sizeof(trace_file));
+        std::error_code error;
+        trace_path_ = trace_file[0] ? std::filesystem::path(trace_file) : std::filesystem::temp_directory_path(error) / "slimevr_driver_trace.json";
+        Trace::SetEnabled(true);
+        logger_->Log("Tracing enabled, the trace is written to {}", trace_path_.string());
+    }
+
     logger_->Log("SlimeVR Driver Loaded Successfully");
 
+    bridge_logger_->SetRateLimitInterval(log_rate_limit);
     bridge_ = std::make_shared<BridgeClient>(
-        std::static_pointer_cast<Logger>(std::make_shared<VRLogger>("Bridge")),
+        std::static_pointer_cast<Logger>(bridge_logger_),
         std::bind(&SlimeVRDriver::VRDriver::OnBridgeMessage, this, std::placeholders::_1),
         std::bind(&SlimeVRDriver::VRDriver::OnBridgeConnect, this));
+    bridge_stats_logged_ = bridge_->GetStats().TakeSnapshot();
+    char capture_file[1024]{};
+    vr::VRSettings()->GetString(settings_key_.c_str(), "bridgeCaptureFile", capture_file, sizeof(capture_file));
+    if (capture_file[0]) {
+        auto capture_max_bytes = static_cast<size_t>(std::max(vr::VRSettings()->GetInt32(settings_key_.c_str(), "bridgeCaptureMaxMB"), 1)) << 20;
+        if (bridge_->StartCapture(capture_file, capture_max_bytes)) {
+            logger_->Log("Recording bridge traffic to {}", capture_file);
+        } else {
+            logger_->Error("Failed to create bridge capture {}", capture_file);
+        }
+    }
     bridge_->Start();
 
     pose_request_thread_ = std::make_unique<std::thread>(&SlimeVRDriver::VRDriver::RunPoseRequestThread, this);
@@ -46,6 +80,15 @@ void SlimeVRDriver::VRDriver::Cleanup() {
     pose_request_thread_.reset();
     logger_->Log("Stopping bridge");
     bridge_->Stop();
+    if (bridge_->GetCapture().IsOpen()) {
+        logger_->Log("Bridge capture finished with {} frames, {} dropped", bridge_->GetCapture().GetRecordedCount(), bridge_->GetCapture().GetDroppedCount());
+        bridge_->StopCapture();
+    }
+    pose_submitter_.Stop();
+    if (Trace::IsEnabled())
+        WriteTrace();
+    // last, so the messages of the threads above are written
+    AsyncLogQueue::ForDriverLog().Stop();
 }
 
 struct DeviceData {
@@ -69,7 +112,7 @@ TrackerRole SlimeVRDriver::VRDriver::GetRoleForDevice(vr::TrackedDeviceIndex_t i
         } else if (controller_role_hint == vr::ETrackedControllerRole::TrackedControllerRole_RightHand) {
             return TrackerRole::RIGHT_HAND;
         } else {
-            logger_->Log("Unknown controller role hint {} for device {}", controller_role_hint, index);
+            logger_->LogRateLimited(index, "Unknown controller role hint {} for device {}", controller_role_hint, index);
             return TrackerRole::NONE;
         }
     }
@@ -77,7 +120,7 @@ TrackerRole SlimeVRDriver::VRDriver::GetRoleForDevice(vr::TrackedDeviceIndex_t i
         vr::ETrackedPropertyError error{ vr::TrackedProp_Success };
         auto controller_type = vr::VRProperties()->GetStringProperty(container, vr::Prop_ControllerType_String, &error);
         if (controller_type.empty()) {
-            logger_->Log("Unable to get controller type for device {}: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
+            logger_->LogRateLimited(index, "Unable to get controller type for device {}: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
             return TrackerRole::NONE;
         }
 
@@ -87,7 +130,7 @@ TrackerRole SlimeVRDriver::VRDriver::GetRoleForDevice(vr::TrackedDeviceIndex_t i
             }
         }
 
-        logger_->Log("Couldn't determine role for device {} (Prop_ControllerType_String='{}')", index, controller_type);
+        logger_->LogRateLimited(index, "Couldn't determine role for device {} (Prop_ControllerType_String='{}')", index, controller_type);
         return TrackerRole::NONE;
     }
     default:
@@ -98,11 +141,13 @@ TrackerRole SlimeVRDriver::VRDriver::GetRoleForDevice(vr::TrackedDeviceIndex_t i
 void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
     std::array<DeviceData, vr::k_unMaxTrackedDeviceCount> devices{};
     logger_->Log("Pose request thread started");
+    Trace::SetThreadName("Pose request");
     steamvr_init_guard_.wait(false);
     // If SteamVR exited before initialisation completed, we'll just
     // skip past the loop body on the first iteration anyway
 
     logger_->Log("Entering pose request loop");
+    auto log_flushed_at = std::chrono::steady_clock::now();
     while (!exiting_) {
         if (!bridge_->IsConnected()) {
             // If bridge not connected, assume we need to resend device add messages
@@ -110,13 +155,29 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
                 device.sent_add_message = false;
                 device.status = messages::TrackerStatus_Status_DISCONNECTED;
             }
+            server_protocol_version_ = 0;
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
             continue;
         }
 
+        // recorded by hand since the iteration ends with a sleep
+        auto iteration_start = std::chrono::steady_clock::now();
         vr::PropertyContainerHandle_t hmd_prop_container = vr::VRProperties()->TrackedDeviceToPropertyContainer(vr::k_unTrackedDeviceIndex_Hmd);
         vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount]{};
-        vr::VRServerDriverHost()->GetRawTrackedDevicePoses(0.0f, poses, std::size(poses));
+        {
+            TRACE_SCOPE("GetRawTrackedDevicePoses");
+            vr::VRServerDriverHost()->GetRawTrackedDevicePoses(0.0f, poses, std::size(poses));
+        }
+        auto sampled_at = std::chrono::steady_clock::now();
+
+        if (server_protocol_version_ >= 3 && sampled_at - ping_sent_at_ >= kPingInterval) {
+            messages::ProtobufMessage* message = google::protobuf::Arena::Create<messages::ProtobufMessage>(&arena_);
+            messages::PingPong* ping = google::protobuf::Arena::Create<messages::PingPong>(&arena_);
+            message->set_allocated_ping_pong(ping);
+            ping->set_sent_at_us(std::chrono::duration_cast<std::chrono::microseconds>(sampled_at.time_since_epoch()).count());
+            bridge_->SendBridgeMessage(*message);
+            ping_sent_at_ = sampled_at;
+        }
 
         vr::ETrackedPropertyError universe_error;
         uint64_t universe = vr::VRProperties()->GetUint64Property(hmd_prop_container, vr::Prop_CurrentUniverseId_Uint64, &universe_error);
@@ -124,8 +185,12 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
             if (!current_universe_.has_value() || current_universe_.value().first != universe) {
                 auto result = SearchUniverses(universe);
                 if (result.has_value()) {
-                    current_universe_.emplace(universe, result.value());
-                    logger_->Log("Found current universe");
+                    auto& trans = result.value();
+                    uint64_t generation = universe_generation_.load(std::memory_order_relaxed) + 1;
+                    current_universe_.emplace(universe, UniverseTransform::FromTranslation(trans, generation));
+                    universe_transform_.Store(current_universe_.value().second);
+                    universe_generation_.store(generation, std::memory_order_release);
+                    logger_->Log("Found current universe: translation=({}, {}, {}), yaw={}", trans.translation.v[0], trans.translation.v[1], trans.translation.v[2], trans.yaw);
                 }
             }
         } else if (universe_error != last_universe_error_) {
@@ -154,13 +219,14 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
             messages::ProtobufMessage* message = google::protobuf::Arena::Create<messages::ProtobufMessage>(&arena_);
 
             {
+                TRACE_SCOPE("GetDeviceProperties");
                 vr::ETrackedPropertyError error{};
 
                 // Don't feed data about our own trackers and Standable's fake ones
                 auto driver_name = vr::VRProperties()->GetStringProperty(prop_container, vr::Prop_TrackingSystemName_String, &error);
                 if (error != vr::TrackedProp_Success) {
                     if (error != vr::TrackedProp_InvalidDevice && error != vr::TrackedProp_UnknownProperty)
-                        logger_->Log("Failed to get Prop_TrackingSystemName_String for device {}: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
+                        logger_->LogRateLimited(index, "Failed to get Prop_TrackingSystemName_String for device {}: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
 
                     continue;
                 }
@@ -169,7 +235,7 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
 
                 auto device_class = (vr::ETrackedDeviceClass)vr::VRProperties()->GetInt32Property(prop_container, vr::Prop_DeviceClass_Int32, &error);
                 if (error != vr::TrackedProp_Success) {
-                    logger_->Log("Failed to get Prop_DeviceClass_Int32 for device {}: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
+                    logger_->LogRateLimited(index, "Failed to get Prop_DeviceClass_Int32 for device {}: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
                     continue;
                 }
 
@@ -188,24 +254,25 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
             }
 
             if (!device.sent_add_message) {
+                TRACE_SCOPE("SendTrackerAdded");
                 vr::ETrackedPropertyError error{};
                 auto serial = vr::VRProperties()->GetStringProperty(prop_container, vr::Prop_SerialNumber_String, &error);
                 if (error != vr::ETrackedPropertyError::TrackedProp_Success) {
-                    logger_->Log("Failed to get device {}'s Prop_SerialNumber_String: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
+                    logger_->LogRateLimited(index, "Failed to get device {}'s Prop_SerialNumber_String: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
                 }
                 if (serial.empty())
                     serial = std::format("Device {}", index);
 
                 auto name = vr::VRProperties()->GetStringProperty(prop_container, vr::Prop_ModelNumber_String, &error);
                 if (error != vr::ETrackedPropertyError::TrackedProp_Success) {
-                    logger_->Log("Failed to get device {}'s Prop_ModelNumber_String: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
+                    logger_->LogRateLimited(index, "Failed to get device {}'s Prop_ModelNumber_String: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
                 }
                 if (name.empty())
                     name = std::format("Device {}", index);
 
                 auto manufacturer = vr::VRProperties()->GetStringProperty(prop_container, vr::Prop_ManufacturerName_String, &error);
                 if (error != vr::ETrackedPropertyError::TrackedProp_Success) {
-                    logger_->Log("Failed to get device {}'s Prop_ManufacturerName_String: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
+                    logger_->LogRateLimited(index, "Failed to get device {}'s Prop_ManufacturerName_String: {}", index, vr::VRPropertiesRaw()->GetPropErrorNameFromEnum(error));
                 }
                 if (manufacturer.empty())
                     name = "OpenVR";
@@ -235,35 +302,8 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
                 vr::HmdQuaternion_t q = GetRotation(pose.mDeviceToAbsoluteTracking);
                 vr::HmdVector3_t pos = GetPosition(pose.mDeviceToAbsoluteTracking);
 
-                if (current_universe_.has_value()) {
-                    auto trans = current_universe_.value().second;
-                    pos.v[0] += trans.translation.v[0];
-                    pos.v[1] += trans.translation.v[1];
-                    pos.v[2] += trans.translation.v[2];
-
-                    // rotate by quaternion w = cos(-trans.yaw / 2), x = 0, y = sin(-trans.yaw / 2), z = 0
-                    auto tmp_w = cos(-trans.yaw / 2);
-                    auto tmp_y = sin(-trans.yaw / 2);
-                    auto new_w = tmp_w * q.w - tmp_y * q.y;
-                    auto new_x = tmp_w * q.x + tmp_y * q.z;
-                    auto new_y = tmp_w * q.y + tmp_y * q.w;
-                    auto new_z = tmp_w * q.z - tmp_y * q.x;
-
-                    q.w = new_w;
-                    q.x = new_x;
-                    q.y = new_y;
-                    q.z = new_z;
-
-                    // rotate point on the xz plane by -trans.yaw radians
-                    // this is equivilant to the quaternion multiplication, after applying the double angle formula.
-                    float tmp_sin = sin(-trans.yaw);
-                    float tmp_cos = cos(-trans.yaw);
-                    auto pos_x = pos.v[0] * tmp_cos + pos.v[2] * tmp_sin;
-                    auto pos_z = pos.v[0] * -tmp_sin + pos.v[2] * tmp_cos;
-
-                    pos.v[0] = pos_x;
-                    pos.v[2] = pos_z;
-                }
+                if (current_universe_.has_value())
+                    current_universe_.value().second.ToUniverse(q, pos);
 
                 messages::Position* position = google::protobuf::Arena::Create<messages::Position>(&arena_);
                 message->set_allocated_position(position);
@@ -276,7 +316,7 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
                 position->set_qy((float)q.y);
                 position->set_qz((float)q.z);
                 position->set_qw((float)q.w);
-                bridge_->SendBridgeMessage(*message);
+                bridge_->SendBridgeMessage(*message, sampled_at);
             } else {
                 notify_status_changed(
                     device,
@@ -301,6 +341,14 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
         }
 
         arena_.Reset();
+        if (Trace::IsEnabled())
+            Trace::Record("PoseRequestIteration", iteration_start, std::chrono::steady_clock::now());
+
+        if (sampled_at - log_flushed_at >= kLogFlushInterval) {
+            logger_->FlushSuppressed();
+            bridge_logger_->FlushSuppressed();
+            log_flushed_at = sampled_at;
+        }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(2));
     }
@@ -308,13 +356,17 @@ void SlimeVRDriver::VRDriver::RunPoseRequestThread() {
 }
 
 void SlimeVRDriver::VRDriver::RunFrame() {
+    Trace::SetThreadName("RunFrame");
+    TRACE_SCOPE("RunFrame");
+    // the previous frame is done with the device table
+    devices_.Quiesce(DeviceTable::Reader::FRAME);
     // Collect events
     vr::VREvent_t event;
-    std::vector<vr::VREvent_t> events;
     auto* properties = vr::VRProperties();
 
+    openvr_events_.BeginFrame();
     while (vr::VRServerDriverHost()->PollNextEvent(&event, sizeof(event))) {
-        events.push_back(event);
+        openvr_events_.Push(event);
 
         if (steamvr_init_guard_) {
             // We already signaled init was done.
@@ -347,7 +399,8 @@ void SlimeVRDriver::VRDriver::RunFrame() {
             steamvr_init_guard_.notify_all();
         }
     }
-    openvr_events_ = std::move(events);
+    openvr_events_.Publish();
+    event_index_.Build(openvr_events_.GetCurrent());
 
     // Update frame timing
     std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
@@ -355,12 +408,34 @@ void SlimeVRDriver::VRDriver::RunFrame() {
     last_frame_time_ = now;
 
     // Update devices
+    for (auto& device : devices_.Get().devices) {
+        device->Update(event_index_);
+    }
+
+    pose_submitter_.RunFrame(devices_);
+
+    if (std::chrono::steady_clock::now() - bridge_stats_logged_.taken_at >= kBridgeStatsInterval)
+        LogBridgeStats();
+}
+
+void SlimeVRDriver::VRDriver::LogBridgeStats() {
+    auto stats = bridge_->GetStats().TakeSnapshot();
+    std::string line;
     {
-        std::lock_guard<std::mutex> lock(devices_mutex_);
-        for (auto& device : devices_) {
-            device->Update();
-        }
+        std::lock_guard<std::mutex> lock(bridge_stats_mutex_);
+        line = BridgeStats::FormatDelta(stats, bridge_stats_logged_);
+        bridge_stats_logged_ = stats;
+    }
+    logger_->Log("Bridge: {}", line);
+}
+
+bool SlimeVRDriver::VRDriver::WriteTrace() {
+    if (!Trace::WriteChromeTrace(trace_path_)) {
+        logger_->Error("Failed to write trace to {}", trace_path_.string());
+        return false;
     }
+    logger_->Log("Wrote trace to {}", trace_path_.string());
+    return true;
 }
 
 void SlimeVRDriver::VRDriver::OnBridgeConnect() {
@@ -378,7 +453,7 @@ void SlimeVRDriver::VRDriver::OnBridgeConnect() {
     t.detach();
 }
 void SlimeVRDriver::VRDriver::OnBridgeMessage(const messages::ProtobufMessage& message) {
-    std::lock_guard<std::mutex> lock(devices_mutex_);
+    devices_.Quiesce(DeviceTable::Reader::BRIDGE);
     if (message.has_tracker_added()) {
         messages::TrackerAdded ta = message.tracker_added();
         switch (GetDeviceType(static_cast<TrackerRole>(ta.tracker_role()))) {
@@ -389,15 +464,13 @@ void SlimeVRDriver::VRDriver::OnBridgeMessage(const messages::ProtobufMessage& m
         }
     } else if (message.has_position()) {
         messages::Position pos = message.position();
-        auto device = devices_by_id_.find(pos.tracker_id());
-        if (device != devices_by_id_.end()) {
-            device->second->PositionMessage(pos);
+        if (auto device = devices_.FindById(pos.tracker_id())) {
+            device->PositionMessage(pos, bridge_->GetReceivedAt());
         }
     } else if (message.has_tracker_status()) {
         messages::TrackerStatus status = message.tracker_status();
-        auto device = devices_by_id_.find(status.tracker_id());
-        if (device != devices_by_id_.end()) {
-            device->second->StatusMessage(status);
+        if (auto device = devices_.FindById(status.tracker_id())) {
+            device->StatusMessage(status);
             static const std::unordered_map<messages::TrackerStatus_Status, std::string> status_map = {
                 { messages::TrackerStatus_Status_OK, "OK" },
                 { messages::TrackerStatus_Status_DISCONNECTED, "DISCONNECTED" },
@@ -410,9 +483,17 @@ void SlimeVRDriver::VRDriver::OnBridgeMessage(const messages::ProtobufMessage& m
         }
     } else if (message.has_battery()) {
         messages::Battery bat = message.battery();
-        auto device = this->devices_by_id_.find(bat.tracker_id());
-        if (device != this->devices_by_id_.end()) {
-            device->second->BatteryMessage(bat);
+        if (auto device = devices_.FindById(bat.tracker_id())) {
+            device->BatteryMessage(bat);
+        }
+    } else if (message.has_version()) {
+        // the server only sends fields newer than the version we announced, features we send are gated on its version
+        server_protocol_version_ = message.version().protocol_version();
+        logger_->Log("Server protocol version {}, driver protocol version {}", message.version().protocol_version(), PROTOCOL_VERSION);
+    } else if (message.has_ping_pong()) {
+        if (message.ping_pong().has_sent_at_us()) {
+            std::chrono::steady_clock::time_point sent_at{ std::chrono::microseconds(message.ping_pong().sent_at_us()) };
+            round_trip_latency_.Record(bridge_->GetReceivedAt() - sent_at);
         }
     }
 }
@@ -428,14 +509,15 @@ void SlimeVRDriver::VRDriver::LeaveStandby() {
 }
 
 std::vector<std::shared_ptr<SlimeVRDriver::IVRDevice>> SlimeVRDriver::VRDriver::GetDevices() {
-    std::lock_guard<std::mutex> lock(devices_mutex_);
-    std::vector<std::shared_ptr<SlimeVRDriver::IVRDevice>> devices;
-    devices.assign(devices.begin(), devices.end());
-    return devices;
+    return devices_.CopyDevices();
 }
 
 const std::vector<vr::VREvent_t>& SlimeVRDriver::VRDriver::GetOpenVREvents() {
-    return openvr_events_;
+    return openvr_events_.GetCurrent();
+}
+
+void SlimeVRDriver::VRDriver::CopyOpenVREvents(std::vector<vr::VREvent_t>& out) {
+    openvr_events_.CopyCurrent(out);
 }
 
 std::chrono::milliseconds SlimeVRDriver::VRDriver::GetLastFrameTime() {
@@ -461,11 +543,11 @@ bool SlimeVRDriver::VRDriver::AddDevice(std::shared_ptr<IVRDevice> device) {
     default:
         return false;
     }
+    std::lock_guard<std::mutex> lock(devices_mutex_);
     if (!devices_by_serial_.count(device->GetSerial())) {
         bool result = vr::VRServerDriverHost()->TrackedDeviceAdded(device->GetSerial().c_str(), openvr_device_class, device.get());
         if (result) {
-            devices_.push_back(device);
-            devices_by_id_[device->GetDeviceId()] = device;
+            devices_.Add(device);
             devices_by_serial_[device->GetSerial()] = device;
             logger_->Log("New tracker device added {} (id {})", device->GetSerial(), device->GetDeviceId());
         } else {
@@ -475,7 +557,7 @@ bool SlimeVRDriver::VRDriver::AddDevice(std::shared_ptr<IVRDevice> device) {
     } else {
         std::shared_ptr<IVRDevice> oldDevice = devices_by_serial_[device->GetSerial()];
         if (oldDevice->GetDeviceId() != device->GetDeviceId()) {
-            devices_by_id_[device->GetDeviceId()] = oldDevice;
+            devices_.MapId(device->GetDeviceId(), oldDevice.get());
             oldDevice->SetDeviceId(device->GetDeviceId());
             logger_->Log("Device overridden from id {} to {} for serial {}", oldDevice->GetDeviceId(), device->GetDeviceId(), device->GetSerial());
         } else {
@@ -524,12 +606,25 @@ vr::IVRServerDriverHost* SlimeVRDriver::VRDriver::GetDriverHost() {
     return vr::VRServerDriverHost();
 }
 
+void SlimeVRDriver::VRDriver::SendBridgeMessage(const messages::ProtobufMessage& message) {
+    if (bridge_)
+        bridge_->SendBridgeMessage(message);
+}
+
+int32_t SlimeVRDriver::VRDriver::GetServerProtocolVersion() {
+    return server_protocol_version_;
+}
+
+SlimeVRDriver::PoseSubmitter& SlimeVRDriver::VRDriver::GetPoseSubmitter() {
+    return pose_submitter_;
+}
+
 //-----------------------------------------------------------------------------
 // Purpose: Calculates quaternion (qw,qx,qy,qz) representing the rotation
 // from: https://github.com/Omnifinity/OpenVR-Tracking-Example/blob/master/HTC%20Lighthouse%20Tracking%20Example/LighthouseTracking.cpp
 //-----------------------------------------------------------------------------
 
-vr::HmdQuaternion_t SlimeVRDriver::VRDriver::GetRotation(vr::HmdMatrix34_t& matrix) {
+vr::HmdQuaternion_t SlimeVRDriver::VRDriver::GetRotation(const vr::HmdMatrix34_t& matrix) {
     vr::HmdQuaternion_t q;
 
     q.w = sqrt(fmax(0, 1 + matrix.m[0][0] + matrix.m[1][1] + matrix.m[2][2])) / 2;
@@ -546,7 +641,7 @@ vr::HmdQuaternion_t SlimeVRDriver::VRDriver::GetRotation(vr::HmdMatrix34_t& matr
 // from: https://github.com/Omnifinity/OpenVR-Tracking-Example/blob/master/HTC%20Lighthouse%20Tracking%20Example/LighthouseTracking.cpp
 //-----------------------------------------------------------------------------
 
-vr::HmdVector3_t SlimeVRDriver::VRDriver::GetPosition(vr::HmdMatrix34_t& matrix) {
+vr::HmdVector3_t SlimeVRDriver::VRDriver::GetPosition(const vr::HmdMatrix34_t& matrix) {
     vr::HmdVector3_t vector;
 
     vector.v[0] = matrix.m[0][3];
@@ -571,6 +666,51 @@ SlimeVRDriver::UniverseTranslation SlimeVRDriver::UniverseTranslation::parse(sim
     return res;
 }
 
+SlimeVRDriver::UniverseTransform SlimeVRDriver::UniverseTransform::FromTranslation(const UniverseTranslation& trans, uint64_t generation) {
+    auto zero_if_nan = [](float value) { return std::isnan(value) ? 0.f : value; };
+    float yaw = zero_if_nan(trans.yaw);
+
+    SlimeVRDriver::UniverseTransform res;
+    res.generation = generation;
+    for (int i = 0; i < 3; i++) {
+        res.world_from_driver_translation[i] = -zero_if_nan(trans.translation.v[i]);
+    }
+    res.world_from_driver_rotation = { std::cos(yaw / 2), 0.0, std::sin(yaw / 2), 0.0 };
+    res.cos_yaw = std::cos(yaw);
+    res.sin_yaw = std::sin(yaw);
+
+    return res;
+}
+
+void SlimeVRDriver::UniverseTransform::ToUniverse(vr::HmdQuaternion_t& q, vr::HmdVector3_t& pos) const {
+    pos.v[0] -= static_cast<float>(world_from_driver_translation[0]);
+    pos.v[1] -= static_cast<float>(world_from_driver_translation[1]);
+    pos.v[2] -= static_cast<float>(world_from_driver_translation[2]);
+
+    // rotate by the inverse of the world-from-driver rotation, w = cos(-yaw / 2), x = 0, y = sin(-yaw / 2), z = 0
+    auto tmp_w = world_from_driver_rotation.w;
+    auto tmp_y = -world_from_driver_rotation.y;
+    auto new_w = tmp_w * q.w - tmp_y * q.y;
+    auto new_x = tmp_w * q.x + tmp_y * q.z;
+    auto new_y = tmp_w * q.y + tmp_y * q.w;
+    auto new_z = tmp_w * q.z - tmp_y * q.x;
+
+    q.w = new_w;
+    q.x = new_x;
+    q.y = new_y;
+    q.z = new_z;
+
+    // rotate point on the xz plane by -yaw radians
+    // this is equivilant to the quaternion multiplication, after applying the double angle formula.
+    float tmp_sin = -sin_yaw;
+    float tmp_cos = cos_yaw;
+    auto pos_x = pos.v[0] * tmp_cos + pos.v[2] * tmp_sin;
+    auto pos_z = pos.v[0] * -tmp_sin + pos.v[2] * tmp_cos;
+
+    pos.v[0] = pos_x;
+    pos.v[2] = pos_z;
+}
+
 std::optional<SlimeVRDriver::UniverseTranslation> SlimeVRDriver::VRDriver::SearchUniverse(const simdjson::padded_string& json, uint64_t target) {
     simdjson::ondemand::document doc = json_parser_.iterate(json);
 
@@ -632,10 +772,37 @@ std::optional<SlimeVRDriver::UniverseTranslation> SlimeVRDriver::VRDriver::Searc
     return std::nullopt;
 }
 
-std::optional<SlimeVRDriver::UniverseTranslation> SlimeVRDriver::VRDriver::GetCurrentUniverse() {
-    if (current_universe_.has_value()) {
-        return current_universe_.value().second;
-    }
+uint64_t SlimeVRDriver::VRDriver::GetUniverseGeneration() {
+    return universe_generation_.load(std::memory_order_acquire);
+}
 
-    return std::nullopt;
+SlimeVRDriver::UniverseTransform SlimeVRDriver::VRDriver::GetUniverseTransform() {
+    return universe_transform_.Load();
+}
+
+SlimeVRDriver::LatencyHistogram& SlimeVRDriver::VRDriver::GetReadToSubmitLatency() {
+    return read_to_submit_latency_;
+}
+
+std::string SlimeVRDriver::VRDriver::DebugRequest(std::string_view request) {
+    if (request == "latency") {
+        return std::format(
+            R"({{"pose_to_write":{},"read_to_submit":{},"round_trip":{}}})",
+            bridge_ ? bridge_->GetWriteLatency().ToJson() : LatencyHistogram().ToJson(),
+            read_to_submit_latency_.ToJson(),
+            round_trip_latency_.ToJson());
+    }
+    if (request == "bridge" && bridge_) {
+        auto stats = bridge_->GetStats().TakeSnapshot();
+        std::lock_guard<std::mutex> lock(bridge_stats_mutex_);
+        return BridgeStats::ToJson(stats, bridge_stats_logged_);
+    }
+    if (request == "trace" && Trace::IsEnabled()) {
+        bool written = WriteTrace();
+        return std::format(R"({{"path":"{}","written":{}}})", trace_path_.generic_string(), written);
+    }
+    if (request == "log") {
+        return std::format(R"({{"dropped":{}}})", AsyncLogQueue::ForDriverLog().GetDroppedCount());
+    }
+    return "";
 }
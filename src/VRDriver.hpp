@@ -2,6 +2,7 @@
 #define NOMINMAX
 
 #include <atomic>
+#include <filesystem>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -14,7 +15,12 @@
 
 #include <simdjson.h>
 
+#include "DeviceTable.hpp"
+#include "FrameEventBuffer.hpp"
+#include "LatencyHistogram.hpp"
 #include "Logger.hpp"
+#include "SeqLock.hpp"
+#include "Trace.hpp"
 #include "TrackerRole.hpp"
 #include "bridge/BridgeClient.hpp"
 
@@ -25,6 +31,7 @@ public:
     // Inherited via IVRDriver
     virtual std::vector<std::shared_ptr<IVRDevice>> GetDevices() override;
     virtual const std::vector<vr::VREvent_t>& GetOpenVREvents() override;
+    virtual void CopyOpenVREvents(std::vector<vr::VREvent_t>& out) override;
     virtual std::chrono::milliseconds GetLastFrameTime() override;
     virtual bool AddDevice(std::shared_ptr<IVRDevice> device) override;
     virtual SettingsValue GetSettingsValue(std::string key) override;
@@ -32,6 +39,9 @@ public:
     virtual vr::IVRDriverInput* GetInput() override;
     virtual vr::CVRPropertyHelpers* GetProperties() override;
     virtual vr::IVRServerDriverHost* GetDriverHost() override;
+    virtual void SendBridgeMessage(const messages::ProtobufMessage& message) override;
+    virtual int32_t GetServerProtocolVersion() override;
+    virtual PoseSubmitter& GetPoseSubmitter() override;
 
     // Inherited via IServerTrackedDeviceProvider
     virtual vr::EVRInitError Init(vr::IVRDriverContext* pDriverContext) override;
@@ -42,12 +52,18 @@ public:
     virtual void LeaveStandby() override;
     virtual ~VRDriver() = default;
 
-    virtual std::optional<UniverseTranslation> GetCurrentUniverse() override;
+    virtual uint64_t GetUniverseGeneration() override;
+    virtual UniverseTransform GetUniverseTransform() override;
+    virtual LatencyHistogram& GetReadToSubmitLatency() override;
+    virtual std::string DebugRequest(std::string_view request) override;
 
     void OnBridgeConnect();
     void OnBridgeMessage(const messages::ProtobufMessage& message);
     void RunPoseRequestThread();
 
+    static vr::HmdQuaternion_t GetRotation(const vr::HmdMatrix34_t& matrix);
+    static vr::HmdVector3_t GetPosition(const vr::HmdMatrix34_t& matrix);
+
 private:
     // set to true if initialisation is done, or we're exiting
     // if we're exiting, this will be true AND exiting_ will be true
@@ -58,23 +74,26 @@ private:
     std::unique_ptr<std::thread> pose_request_thread_ = nullptr;
 
     TrackerRole GetRoleForDevice(vr::TrackedDeviceIndex_t index) const;
+    void LogBridgeStats();
+    bool WriteTrace();
 
     std::shared_ptr<BridgeClient> bridge_ = nullptr;
     google::protobuf::Arena arena_;
     std::shared_ptr<VRLogger> logger_ = std::make_shared<VRLogger>();
+    // used by the bridge's IO thread, its suppressed messages are flushed with the driver's own
+    std::shared_ptr<VRLogger> bridge_logger_ = std::make_shared<VRLogger>("Bridge");
+    // only taken by AddDevice, lookups go through the lock-free devices_ table
     std::mutex devices_mutex_;
-    std::vector<std::shared_ptr<IVRDevice>> devices_;
-    std::vector<vr::VREvent_t> openvr_events_;
-    std::map<int, std::shared_ptr<IVRDevice>> devices_by_id_;
+    DeviceTable devices_;
+    PoseSubmitter pose_submitter_{ std::static_pointer_cast<Logger>(std::make_shared<VRLogger>("PoseSubmitter")) };
+    FrameEventBuffer openvr_events_;
+    EventIndex event_index_;
     std::map<std::string, std::shared_ptr<IVRDevice>> devices_by_serial_;
     std::chrono::milliseconds frame_timing_ = std::chrono::milliseconds(16);
     std::chrono::steady_clock::time_point last_frame_time_ = std::chrono::steady_clock::now();
     std::chrono::steady_clock::time_point battery_sent_at_ = std::chrono::steady_clock::now();
     std::string settings_key_ = "driver_slimevr";
 
-    vr::HmdQuaternion_t GetRotation(vr::HmdMatrix34_t& matrix);
-    vr::HmdVector3_t GetPosition(vr::HmdMatrix34_t& matrix);
-
     bool sent_hmd_add_message_ = false;
 
     simdjson::ondemand::parser json_parser_;
@@ -82,7 +101,29 @@ private:
     // std::map<int, UniverseTranslation> universes;
 
     vr::ETrackedPropertyError last_universe_error_;
-    std::optional<std::pair<uint64_t, UniverseTranslation>> current_universe_ = std::nullopt;
+    // owned by the pose request thread, devices read the copy published in universe_transform_
+    std::optional<std::pair<uint64_t, UniverseTransform>> current_universe_ = std::nullopt;
+    SeqLock<UniverseTransform> universe_transform_;
+    std::atomic<uint64_t> universe_generation_ = 0;
+
+    // protocol version reported by the server, 0 until it sent one
+    std::atomic<int32_t> server_protocol_version_ = 0;
+    // servers from protocol version 3 on echo pings, one is sent this often to measure the round trip
+    static constexpr std::chrono::seconds kPingInterval{ 1 };
+    std::chrono::steady_clock::time_point ping_sent_at_{};
+    LatencyHistogram read_to_submit_latency_;
+    LatencyHistogram round_trip_latency_;
+
+    // bridge counters are logged this often, tracker rates in debug requests are relative to the last log
+    static constexpr std::chrono::seconds kBridgeStatsInterval{ 60 };
+    // how often the pose request thread reports messages that stopped repeating, see Logger::LogRateLimited
+    static constexpr std::chrono::seconds kLogFlushInterval{ 1 };
+    // written by RunFrame, read by debug requests
+    std::mutex bridge_stats_mutex_;
+    BridgeStats::Snapshot bridge_stats_logged_;
+
+    // where the trace is written at shutdown and on "trace" debug requests if traceEnabled is set
+    std::filesystem::path trace_path_;
     std::optional<UniverseTranslation> SearchUniverse(const simdjson::padded_string& json, uint64_t target);
     std::optional<UniverseTranslation> SearchUniverses(uint64_t target);
 };
@@ -0,0 +1,103 @@
+#include "VelocityEstimator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "PoseMath.hpp"
+
+void SlimeVRDriver::VelocityEstimator::Push(const vr::DriverPose_t& pose, std::chrono::steady_clock::time_point time) {
+    if (count_ > 0) {
+        double since_newest = std::chrono::duration<double>(time - At(0).time).count();
+        if (since_newest > kWindowSeconds || since_newest < 0.0) {
+            Reset();
+        } else if (since_newest >= kMinIntervalSeconds) {
+            newest_ = (newest_ + 1) % kCapacity;
+            count_ = std::min(count_ + 1, kCapacity);
+        }
+    }
+    if (count_ == 0)
+        count_ = 1;
+
+    // a pose from the same burst replaces the newest one
+    Sample& sample = samples_[newest_];
+    for (int i = 0; i < 3; i++)
+        sample.position[i] = pose.vecPosition[i];
+    sample.rotation = pose.qRotation;
+    sample.time = time;
+}
+
+bool SlimeVRDriver::VelocityEstimator::Estimate(double (&velocity)[3], double (&angular_velocity)[3]) const {
+    Rates linear;
+    Rates angular;
+    size_t rate_count = 0;
+    const Sample& newest = At(0);
+    for (size_t age = 1; age < count_; age++) {
+        const Sample& older = At(age);
+        if (std::chrono::duration<double>(newest.time - older.time).count() > kWindowSeconds)
+            break;
+        const Sample& newer = At(age - 1);
+        double dt = std::chrono::duration<double>(newer.time - older.time).count();
+        for (int i = 0; i < 3; i++)
+            linear[rate_count].value[i] = (newer.position[i] - older.position[i]) / dt;
+        AngularVelocityBetween(older.rotation, newer.rotation, dt, angular[rate_count].value);
+        linear[rate_count].dt = dt;
+        angular[rate_count].dt = dt;
+        rate_count++;
+    }
+
+    if (rate_count == 0) {
+        for (int i = 0; i < 3; i++) {
+            velocity[i] = 0.0;
+            angular_velocity[i] = 0.0;
+        }
+        return false;
+    }
+    RobustMean(linear, rate_count, kLinearToleranceMetersPerSecond, velocity);
+    RobustMean(angular, rate_count, kAngularToleranceRadiansPerSecond, angular_velocity);
+    return true;
+}
+
+void SlimeVRDriver::VelocityEstimator::Reset() {
+    newest_ = 0;
+    count_ = 0;
+}
+
+void SlimeVRDriver::VelocityEstimator::RobustMean(const Rates& rates, size_t count, double tolerance, double (&out)[3]) {
+    std::array<double, kCapacity - 1> values;
+    auto median = [&](size_t n) {
+        auto middle = values.begin() + n / 2;
+        std::nth_element(values.begin(), middle, values.begin() + n);
+        return *middle;
+    };
+
+    double center[3];
+    for (int i = 0; i < 3; i++) {
+        for (size_t j = 0; j < count; j++)
+            values[j] = rates[j].value[i];
+        center[i] = median(count);
+    }
+
+    std::array<double, kCapacity - 1> deviations;
+    for (size_t j = 0; j < count; j++) {
+        double sum = 0.0;
+        for (int i = 0; i < 3; i++)
+            sum += (rates[j].value[i] - center[i]) * (rates[j].value[i] - center[i]);
+        deviations[j] = std::sqrt(sum);
+        values[j] = deviations[j];
+    }
+    // with fewer than three rates there is no majority to tell the outlier apart
+    double threshold = count < 3 ? INFINITY : kOutlierScale * median(count) + tolerance;
+
+    double weight = 0.0;
+    double sum[3] = {};
+    for (size_t j = 0; j < count; j++) {
+        if (deviations[j] > threshold)
+            continue;
+        for (int i = 0; i < 3; i++)
+            sum[i] += rates[j].value[i] * rates[j].dt;
+        weight += rates[j].dt;
+    }
+    // at least half of the rates are within one median absolute deviation, so weight is never zero
+    for (int i = 0; i < 3; i++)
+        out[i] = sum[i] / weight;
+}
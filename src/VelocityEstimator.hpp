@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+#include <openvr_driver.h>
+
+namespace SlimeVRDriver {
+
+/**
+ * Estimates linear and angular velocity from the most recent poses of a tracker, for servers that don't send them.
+ *
+ * Every pair of consecutive poses in a short window gives a rate of change. Rates far from their median, as caused by
+ * a glitched pose or by messages arriving in a burst, are rejected and the rest are averaged weighted by their time
+ * span, so the result is the overall displacement over the window minus the outliers.
+ *
+ * Not thread safe, meant to be owned by the thread that handles the device's messages.
+ */
+class VelocityEstimator {
+public:
+    static constexpr size_t kCapacity = 8;
+    // poses older than this, relative to the newest, no longer describe the current motion
+    static constexpr double kWindowSeconds = 0.05;
+    // poses closer together than this arrived in the same burst, only the newer one is kept
+    static constexpr double kMinIntervalSeconds = 0.001;
+    // rates further from the median than this many median absolute deviations are rejected
+    static constexpr double kOutlierScale = 3.0;
+    // deviations below these are never rejected, so noise-free input doesn't reject on rounding errors
+    static constexpr double kLinearToleranceMetersPerSecond = 0.02;
+    static constexpr double kAngularToleranceRadiansPerSecond = 0.05;
+
+    /**
+     * Adds a pose. A gap longer than the window starts over, since the motion before it is unrelated.
+     */
+    void Push(const vr::DriverPose_t& pose, std::chrono::steady_clock::time_point time);
+
+    /**
+     * Estimates the current velocities, in the same frame as the pushed poses.
+     *
+     * @param velocity Linear velocity in units per second, zeroed if there is no estimate.
+     * @param angular_velocity Angular velocity as an axis scaled by radians per second, zeroed if there is no estimate.
+     * @return False if there are not enough recent poses for an estimate.
+     */
+    bool Estimate(double (&velocity)[3], double (&angular_velocity)[3]) const;
+
+    void Reset();
+
+private:
+    struct Sample {
+        double position[3];
+        vr::HmdQuaternion_t rotation;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    struct Rate {
+        double value[3];
+        double dt;
+    };
+
+    using Rates = std::array<Rate, kCapacity - 1>;
+
+    /**
+     * Averages the first `count` rates weighted by their time span, leaving out outliers.
+     */
+    static void RobustMean(const Rates& rates, size_t count, double tolerance, double (&out)[3]);
+
+    const Sample& At(size_t age) const {
+        return samples_[(newest_ + kCapacity - age) % kCapacity];
+    }
+
+    std::array<Sample, kCapacity> samples_{};
+    size_t newest_ = 0;
+    size_t count_ = 0;
+};
+
+} // namespace SlimeVRDriver
@@ -0,0 +1,201 @@
+/*
+    SlimeVR Code is placed under the MIT license
+    Copyright (c) 2022 SlimeVR Contributors
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+#include "BridgeCapture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+void WriteLE(char* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+    }
+}
+
+uint64_t ReadLE(const char* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(in[i])) << (i * 8);
+    }
+    return value;
+}
+
+} // namespace
+
+bool BridgeCapture::Open(const std::filesystem::path& path, size_t max_bytes) {
+    Close();
+    if (max_bytes < kHeaderSize)
+        return false;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    // allocated up front, so a full disk fails here instead of writes to the mapping
+    FILE_ALLOCATION_INFO allocation{};
+    allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(max_bytes);
+    if (!SetFileInformationByHandle(file, FileAllocationInfo, &allocation, sizeof(allocation))) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(max_bytes) >> 32), static_cast<DWORD>(max_bytes), nullptr);
+    void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, max_bytes) : nullptr;
+    if (!data) {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    file_ = file;
+    mapping_ = mapping;
+#else
+    int file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file < 0)
+        return false;
+    // allocated up front rather than a sparse file, writing to a page the disk has no space for raises SIGBUS
+    void* data = posix_fallocate(file, 0, static_cast<off_t>(max_bytes)) == 0
+        ? mmap(nullptr, max_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0)
+        : MAP_FAILED;
+    if (data == MAP_FAILED) {
+        close(file);
+        return false;
+    }
+    file_ = file;
+#endif
+
+    char* out = static_cast<char*>(data);
+    capacity_ = max_bytes;
+    started_at_ = std::chrono::steady_clock::now();
+    std::memcpy(out, kMagic, sizeof(kMagic));
+    WriteLE(out + 8, kVersion, 4);
+    WriteLE(out + 12, 0, 4);
+    auto unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    WriteLE(out + 16, static_cast<uint64_t>(unix_ns), 8);
+    reserved_ = kHeaderSize;
+    used_ = kHeaderSize;
+    recorded_ = 0;
+    dropped_ = 0;
+    // published last, Appends only use the fields above once they see it
+    data_.store(out);
+    return true;
+}
+
+void BridgeCapture::Close() {
+    char* data = data_.exchange(nullptr);
+    if (!data)
+        return;
+    // Appends that saw the mapping before it was cleared finish their frame, later ones see it cleared
+    while (appending_.load() != 0) {
+        std::this_thread::yield();
+    }
+    size_t used = used_.load();
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping_);
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(used);
+    SetFilePointerEx(file_, size, nullptr, FILE_BEGIN);
+    SetEndOfFile(file_);
+    CloseHandle(file_);
+    mapping_ = nullptr;
+    file_ = nullptr;
+#else
+    munmap(data, capacity_);
+    // if this fails the rest of the file stays zeroed, which Read takes as the end
+    [[maybe_unused]] int truncated = ftruncate(file_, static_cast<off_t>(used));
+    close(file_);
+    file_ = -1;
+#endif
+
+    capacity_ = 0;
+}
+
+bool BridgeCapture::Append(Direction direction, const char* payload, uint32_t size, std::chrono::steady_clock::time_point at) {
+    // announced before loading the mapping, both sequentially consistent so Close either sees it or this sees nullptr
+    appending_.fetch_add(1);
+    char* data = data_.load();
+    bool appended = data && AppendTo(data, direction, payload, size, at);
+    appending_.fetch_sub(1, std::memory_order_release);
+    return appended;
+}
+
+bool BridgeCapture::AppendTo(char* data, Direction direction, const char* payload, uint32_t size, std::chrono::steady_clock::time_point at) {
+    size_t record_size = kRecordOverhead + size;
+    size_t offset = reserved_.fetch_add(record_size, std::memory_order_relaxed);
+    if (offset + record_size > capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto timestamp = std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(at - started_at_).count(), 0);
+    char* out = data + offset;
+    WriteLE(out, static_cast<uint64_t>(timestamp) << 1 | static_cast<uint64_t>(direction), 8);
+    WriteLE(out + 8, size + 4, 4);
+    std::memcpy(out + kRecordOverhead, payload, size);
+
+    size_t end = offset + record_size;
+    size_t used = used_.load(std::memory_order_relaxed);
+    while (end > used && !used_.compare_exchange_weak(used, end, std::memory_order_relaxed)) { }
+    recorded_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool BridgeCapture::Read(const std::filesystem::path& path, std::vector<char>& data, std::vector<Record>& records) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (data.size() < kHeaderSize || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0 || ReadLE(data.data() + 8, 4) != kVersion)
+        return false;
+
+    records.clear();
+    size_t offset = kHeaderSize;
+    while (offset + kRecordOverhead <= data.size()) {
+        uint64_t stamp = ReadLE(data.data() + offset, 8);
+        auto length = static_cast<uint32_t>(ReadLE(data.data() + offset + 8, 4));
+        // zeroed space of a capture that wasn't closed
+        if (length < 4 || offset + kRecordOverhead + (length - 4) > data.size())
+            break;
+        records.push_back({
+            std::chrono::nanoseconds(stamp >> 1),
+            static_cast<Direction>(stamp & 1),
+            std::string_view(data.data() + offset + kRecordOverhead, length - 4),
+        });
+        offset += kRecordOverhead + (length - 4);
+    }
+    return true;
+}
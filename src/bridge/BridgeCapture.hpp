@@ -0,0 +1,137 @@
+/*
+    SlimeVR Code is placed under the MIT license
+    Copyright (c) 2022 SlimeVR Contributors
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Records the frames of a bridge connection to a memory-mapped capture file.
+ *
+ * The file is allocated and mapped at its maximum size when opened, appending a frame reserves its space with an atomic
+ * add and copies it into the mapping, so recording never blocks or makes a system call on the IO thread. Frames that
+ * don't fit anymore are dropped and counted. Closing waits for frames being appended and truncates the file to the
+ * recorded frames.
+ *
+ * File format, all integers little-endian:
+ * - header: "SVRBCAP\0", uint32 version, uint32 reserved, uint64 unix time of the start in ns
+ * - records: uint64 ns since the start << 1 | direction (0 received, 1 sent), followed by the frame as it is on the wire,
+ *   a uint32 length that includes itself and the protobuf payload
+ */
+class BridgeCapture {
+public:
+    static constexpr char kMagic[8] = { 'S', 'V', 'R', 'B', 'C', 'A', 'P', '\0' };
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kHeaderSize = 24;
+    // timestamp and frame length
+    static constexpr size_t kRecordOverhead = 12;
+
+    // not IN and OUT, windows.h defines those
+    enum class Direction : uint8_t {
+        RECEIVED = 0,
+        SENT = 1,
+    };
+
+    struct Record {
+        std::chrono::nanoseconds timestamp;
+        Direction direction;
+        // protobuf payload without the length
+        std::string_view payload;
+    };
+
+    BridgeCapture() = default;
+    ~BridgeCapture() {
+        Close();
+    }
+
+    BridgeCapture(const BridgeCapture&) = delete;
+    BridgeCapture& operator=(const BridgeCapture&) = delete;
+
+    /**
+     * @brief Creates or replaces the capture file and maps it.
+     *
+     * @param max_bytes Size of the mapping, frames beyond it are dropped.
+     * @return false if the file couldn't be created, its space allocated or mapped.
+     */
+    bool Open(const std::filesystem::path& path, size_t max_bytes);
+
+    /**
+     * @brief Unmaps the file and truncates it to the recorded frames. Safe to call while other threads append, it
+     * waits for their frames and later Appends are ignored. Must not run concurrently with Open.
+     */
+    void Close();
+
+    bool IsOpen() const {
+        return data_.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /**
+     * @brief Appends a frame. Safe to call from multiple threads.
+     *
+     * @param payload The protobuf payload of the frame.
+     * @param at When the frame was read or queued for writing.
+     * @return false if the capture is full or closed.
+     */
+    bool Append(Direction direction, const char* payload, uint32_t size, std::chrono::steady_clock::time_point at);
+
+    uint64_t GetRecordedCount() const {
+        return recorded_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetDroppedCount() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Reads all records of a capture file into memory.
+     *
+     * @param data Receives the file contents, the payloads of the records point into it.
+     * @return false if the file couldn't be read or isn't a capture. A truncated last record is ignored.
+     */
+    static bool Read(const std::filesystem::path& path, std::vector<char>& data, std::vector<Record>& records);
+
+private:
+    bool AppendTo(char* data, Direction direction, const char* payload, uint32_t size, std::chrono::steady_clock::time_point at);
+
+    // set once the file is mapped, cleared by Close before it waits for appending_ to drop to 0
+    std::atomic<char*> data_ = nullptr;
+    // Appends that may still use data_
+    std::atomic<uint32_t> appending_ = 0;
+    size_t capacity_ = 0;
+    std::chrono::steady_clock::time_point started_at_{};
+    std::atomic<size_t> reserved_ = 0;
+    // end of the last record that fit, records are reserved in order so everything before it is recorded
+    std::atomic<size_t> used_ = 0;
+    std::atomic<uint64_t> recorded_ = 0;
+    std::atomic<uint64_t> dropped_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
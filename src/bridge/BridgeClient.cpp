@@ -66,6 +66,7 @@ void BridgeClient::ResetConnection() {
 }
 
 void BridgeClient::Reconnect() {
+    stats_.CountReconnect();
     CloseConnectionHandles();
     reconnect_timeout_ = GetLoop()->resource<uvw::timer_handle>();
     reconnect_timeout_->start(1000ms, 0ms);
@@ -28,7 +28,7 @@
 
 #include "BridgeTransport.hpp"
 
-#define PROTOCOL_VERSION 2
+#define PROTOCOL_VERSION 3
 
 /**
  * @brief Client implementation for communication with SlimeVR Server using pipes or unix sockets.
@@ -0,0 +1,195 @@
+/*
+    SlimeVR Code is placed under the MIT license
+    Copyright (c) 2022 SlimeVR Contributors
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+#include "BridgeStats.hpp"
+
+#include <algorithm>
+#include <format>
+
+size_t BridgeStats::GetMessageType(const messages::ProtobufMessage& message) {
+    return std::min(static_cast<size_t>(message.message_case()), kMessageTypes - 1);
+}
+
+const char* BridgeStats::GetMessageTypeName(size_t type) {
+    switch (type) {
+    case messages::ProtobufMessage::kPosition:
+        return "position";
+    case messages::ProtobufMessage::kUserAction:
+        return "user_action";
+    case messages::ProtobufMessage::kTrackerAdded:
+        return "tracker_added";
+    case messages::ProtobufMessage::kTrackerStatus:
+        return "tracker_status";
+    case messages::ProtobufMessage::kBattery:
+        return "battery";
+    case messages::ProtobufMessage::kVersion:
+        return "version";
+    case messages::ProtobufMessage::kHapticFeedback:
+        return "haptic_feedback";
+    case messages::ProtobufMessage::kPingPong:
+        return "ping_pong";
+    case messages::ProtobufMessage::MESSAGE_NOT_SET:
+        return "none";
+    default:
+        return "unknown";
+    }
+}
+
+void BridgeStats::CountIn(const messages::ProtobufMessage& message, size_t bytes) {
+    size_t type = GetMessageType(message);
+    Increment(in_.messages[type]);
+    in_.bytes[type].fetch_add(bytes, std::memory_order_relaxed);
+    if (message.has_position()) {
+        int32_t id = message.position().tracker_id();
+        Increment(tracker_positions_[id >= 0 && id <= kMaxTrackerId ? id : kMaxTrackerId + 1]);
+    }
+}
+
+void BridgeStats::CountOut(const messages::ProtobufMessage& message, size_t bytes) {
+    size_t type = GetMessageType(message);
+    Increment(out_.messages[type]);
+    out_.bytes[type].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+BridgeStats::Snapshot BridgeStats::TakeSnapshot() const {
+    Snapshot snapshot;
+    snapshot.taken_at = std::chrono::steady_clock::now();
+    for (size_t type = 0; type < kMessageTypes; type++) {
+        snapshot.in.messages[type] = in_.messages[type].load(std::memory_order_relaxed);
+        snapshot.in.bytes[type] = in_.bytes[type].load(std::memory_order_relaxed);
+        snapshot.out.messages[type] = out_.messages[type].load(std::memory_order_relaxed);
+        snapshot.out.bytes[type] = out_.bytes[type].load(std::memory_order_relaxed);
+    }
+    for (size_t id = 0; id < tracker_positions_.size(); id++) {
+        snapshot.tracker_positions[id] = tracker_positions_[id].load(std::memory_order_relaxed);
+    }
+    snapshot.parse_failures = parse_failures_.load(std::memory_order_relaxed);
+    snapshot.oversized_messages = oversized_messages_.load(std::memory_order_relaxed);
+    snapshot.recv_buffer_full = recv_buffer_full_.load(std::memory_order_relaxed);
+    snapshot.send_buffer_full = send_buffer_full_.load(std::memory_order_relaxed);
+    snapshot.resets = resets_.load(std::memory_order_relaxed);
+    snapshot.reconnects = reconnects_.load(std::memory_order_relaxed);
+    snapshot.connects = connects_.load(std::memory_order_relaxed);
+    snapshot.recv_high_water = recv_high_water_.load(std::memory_order_relaxed);
+    snapshot.send_high_water = send_high_water_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+namespace {
+
+std::string TrafficToJson(const BridgeStats::Traffic& traffic) {
+    std::string json = "{";
+    for (size_t type = 0; type < BridgeStats::kMessageTypes; type++) {
+        if (!traffic.messages[type])
+            continue;
+        if (json.size() > 1)
+            json += ',';
+        std::format_to(
+            std::back_inserter(json),
+            R"("{}":{{"messages":{},"bytes":{}}})",
+            BridgeStats::GetMessageTypeName(type),
+            traffic.messages[type],
+            traffic.bytes[type]);
+    }
+    return json + "}";
+}
+
+uint64_t Total(const std::array<uint64_t, BridgeStats::kMessageTypes>& counts) {
+    uint64_t total = 0;
+    for (uint64_t count : counts)
+        total += count;
+    return total;
+}
+
+double SecondsBetween(const BridgeStats::Snapshot& now, const BridgeStats::Snapshot& since) {
+    return std::max(std::chrono::duration<double>(now.taken_at - since.taken_at).count(), 1e-3);
+}
+
+} // namespace
+
+std::string BridgeStats::ToJson(const Snapshot& now, const Snapshot& since) {
+    double seconds = SecondsBetween(now, since);
+    std::string trackers;
+    for (size_t id = 0; id < now.tracker_positions.size(); id++) {
+        if (!now.tracker_positions[id])
+            continue;
+        if (!trackers.empty())
+            trackers += ',';
+        std::format_to(
+            std::back_inserter(trackers),
+            R"({{"id":{},"positions":{},"rate_hz":{:.1f}}})",
+            id <= kMaxTrackerId ? std::to_string(id) : "\"other\"",
+            now.tracker_positions[id],
+            (now.tracker_positions[id] - since.tracker_positions[id]) / seconds);
+    }
+
+    return std::format(
+        R"({{"in":{},"out":{},"parse_failures":{},"oversized_messages":{},"recv_buffer_full":{},"send_buffer_full":{},)"
+        R"("resets":{},"reconnects":{},"connects":{},"recv_high_water":{},"send_high_water":{},"rate_window_s":{:.1f},"trackers":[{}]}})",
+        TrafficToJson(now.in),
+        TrafficToJson(now.out),
+        now.parse_failures,
+        now.oversized_messages,
+        now.recv_buffer_full,
+        now.send_buffer_full,
+        now.resets,
+        now.reconnects,
+        now.connects,
+        now.recv_high_water,
+        now.send_high_water,
+        seconds,
+        trackers);
+}
+
+std::string BridgeStats::FormatDelta(const Snapshot& now, const Snapshot& since) {
+    double seconds = SecondsBetween(now, since);
+    std::string line = std::format(
+        "in {:.1f} msg/s {:.1f} KiB/s, out {:.1f} msg/s {:.1f} KiB/s",
+        (Total(now.in.messages) - Total(since.in.messages)) / seconds,
+        (Total(now.in.bytes) - Total(since.in.bytes)) / seconds / 1024.0,
+        (Total(now.out.messages) - Total(since.out.messages)) / seconds,
+        (Total(now.out.bytes) - Total(since.out.bytes)) / seconds / 1024.0);
+
+    // only mention problems that happened in this window
+    auto append_count = [&](const char* name, uint64_t now_count, uint64_t since_count) {
+        if (now_count != since_count)
+            std::format_to(std::back_inserter(line), ", {} {}", now_count - since_count, name);
+    };
+    append_count("parse failures", now.parse_failures, since.parse_failures);
+    append_count("oversized messages", now.oversized_messages, since.oversized_messages);
+    append_count("recv buffer full", now.recv_buffer_full, since.recv_buffer_full);
+    append_count("send buffer full", now.send_buffer_full, since.send_buffer_full);
+    append_count("resets", now.resets, since.resets);
+    append_count("reconnects", now.reconnects, since.reconnects);
+    std::format_to(std::back_inserter(line), ", buffer high water recv {} send {} bytes", now.recv_high_water, now.send_high_water);
+
+    for (size_t id = 0; id < now.tracker_positions.size(); id++) {
+        uint64_t positions = now.tracker_positions[id] - since.tracker_positions[id];
+        if (!positions)
+            continue;
+        if (id <= kMaxTrackerId)
+            std::format_to(std::back_inserter(line), ", tracker {} {:.1f} Hz", id, positions / seconds);
+        else
+            std::format_to(std::back_inserter(line), ", other trackers {:.1f} Hz", positions / seconds);
+    }
+    return line;
+}
@@ -0,0 +1,159 @@
+/*
+    SlimeVR Code is placed under the MIT license
+    Copyright (c) 2022 SlimeVR Contributors
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in
+    all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "ProtobufMessages.pb.h"
+
+/**
+ * @brief Always-on counters describing the traffic and health of a bridge connection.
+ *
+ * Counters are relaxed atomics, bumped from the thread that sees the event, and read as a whole with `TakeSnapshot()`.
+ * Counting costs an uncontended atomic increment, so it stays enabled in release builds.
+ */
+class BridgeStats {
+public:
+    // covers every ProtobufMessage::MessageCase, 0 is a message without a type
+    static constexpr size_t kMessageTypes = 16;
+    // positions of trackers with larger ids are counted together
+    static constexpr int32_t kMaxTrackerId = 255;
+
+    struct Traffic {
+        std::array<uint64_t, kMessageTypes> messages{};
+        std::array<uint64_t, kMessageTypes> bytes{};
+    };
+
+    struct Snapshot {
+        std::chrono::steady_clock::time_point taken_at{};
+        Traffic in;
+        Traffic out;
+        uint64_t parse_failures = 0;
+        uint64_t oversized_messages = 0;
+        uint64_t recv_buffer_full = 0;
+        uint64_t send_buffer_full = 0;
+        uint64_t resets = 0;
+        uint64_t reconnects = 0;
+        uint64_t connects = 0;
+        uint64_t recv_high_water = 0;
+        uint64_t send_high_water = 0;
+        // the last entry counts all ids above kMaxTrackerId
+        std::array<uint64_t, kMaxTrackerId + 2> tracker_positions{};
+    };
+
+    /**
+     * @brief Counts a received message. Called from the event loop thread.
+     */
+    void CountIn(const messages::ProtobufMessage& message, size_t bytes);
+
+    /**
+     * @brief Counts a sent message. Called from any sending thread.
+     */
+    void CountOut(const messages::ProtobufMessage& message, size_t bytes);
+
+    void CountParseFailure() {
+        Increment(parse_failures_);
+    }
+    void CountOversizedMessage() {
+        Increment(oversized_messages_);
+    }
+    void CountRecvBufferFull() {
+        Increment(recv_buffer_full_);
+    }
+    void CountSendBufferFull() {
+        Increment(send_buffer_full_);
+    }
+    void CountReset() {
+        Increment(resets_);
+    }
+    void CountReconnect() {
+        Increment(reconnects_);
+    }
+    void CountConnect() {
+        Increment(connects_);
+    }
+
+    /**
+     * @brief Records the number of bytes waiting in a buffer, keeping the largest.
+     */
+    void UpdateRecvHighWater(size_t bytes) {
+        UpdateMax(recv_high_water_, bytes);
+    }
+    void UpdateSendHighWater(size_t bytes) {
+        UpdateMax(send_high_water_, bytes);
+    }
+
+    Snapshot TakeSnapshot() const;
+
+    /**
+     * @brief Formats a snapshot as a JSON object.
+     *
+     * @param now The snapshot to format.
+     * @param since Earlier snapshot that tracker rates are computed against.
+     */
+    static std::string ToJson(const Snapshot& now, const Snapshot& since);
+
+    /**
+     * @brief Formats the change between two snapshots as a single log line.
+     */
+    static std::string FormatDelta(const Snapshot& now, const Snapshot& since);
+
+    /**
+     * @brief Returns the name of a message type, as in the ProtobufMessage oneof.
+     */
+    static const char* GetMessageTypeName(size_t type);
+
+private:
+    static void Increment(std::atomic<uint64_t>& counter) {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void UpdateMax(std::atomic<uint64_t>& counter, uint64_t value) {
+        uint64_t current = counter.load(std::memory_order_relaxed);
+        while (value > current && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed)) { }
+    }
+
+    static size_t GetMessageType(const messages::ProtobufMessage& message);
+
+    // inbound counters are only written from the event loop thread, outbound ones from the senders
+    struct AtomicTraffic {
+        std::array<std::atomic<uint64_t>, kMessageTypes> messages{};
+        std::array<std::atomic<uint64_t>, kMessageTypes> bytes{};
+    };
+    alignas(64) AtomicTraffic in_;
+    std::array<std::atomic<uint64_t>, kMaxTrackerId + 2> tracker_positions_{};
+    std::atomic<uint64_t> recv_high_water_ = 0;
+    alignas(64) AtomicTraffic out_;
+    std::atomic<uint64_t> send_high_water_ = 0;
+    alignas(64) std::atomic<uint64_t> parse_failures_ = 0;
+    std::atomic<uint64_t> oversized_messages_ = 0;
+    std::atomic<uint64_t> recv_buffer_full_ = 0;
+    std::atomic<uint64_t> send_buffer_full_ = 0;
+    std::atomic<uint64_t> resets_ = 0;
+    std::atomic<uint64_t> reconnects_ = 0;
+    std::atomic<uint64_t> connects_ = 0;
+};
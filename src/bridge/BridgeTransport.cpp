@@ -43,6 +43,7 @@ void BridgeTransport::StopAsync() {
 
 void BridgeTransport::RunThread() {
     logger_->Log("thread started");
+    SlimeVRDriver::Trace::SetThreadName("Bridge IO");
     loop_ = uvw::loop::create();
     stop_signal_handle_ = GetLoop()->resource<uvw::async_handle>();
     write_signal_handle_ = GetLoop()->resource<uvw::async_handle>();
@@ -66,19 +67,27 @@ void BridgeTransport::RunThread() {
 
 void BridgeTransport::ResetBuffers() {
     recv_buf_.Clear();
+    std::lock_guard<std::mutex> lock(send_mutex_);
     send_buf_.Clear();
+    oldest_unwritten_sample_.reset();
 }
 
 void BridgeTransport::OnConnect() {
+    stats_.CountConnect();
     if (connect_callback_)
         (*connect_callback_)();
 }
 void BridgeTransport::OnRecv(const uvw::data_event& event) {
+    TRACE_SCOPE("OnRecv");
+    received_at_ = std::chrono::steady_clock::now();
     if (!recv_buf_.Push(event.data.get(), event.length)) {
         logger_->Log("recv_buf_.Push({}) failed", event.length);
+        stats_.CountRecvBufferFull();
+        stats_.CountReset();
         ResetConnection();
         return;
     }
+    stats_.UpdateRecvHighWater(recv_buf_.BytesAvailable());
 
     size_t available;
     while ((available = recv_buf_.BytesAvailable())) {
@@ -94,66 +103,110 @@ void BridgeTransport::OnRecv(const uvw::data_event& event) {
             (static_cast<uint32_t>(static_cast<uint8_t>(len_buf[3])) << 24);
 
         if (size > VRBRIDGE_MAX_MESSAGE_SIZE) {
-            logger_->Log(
+            logger_->LogRateLimited(
+                0,
                 "message size overflow: {} > {}",
                 size, VRBRIDGE_MAX_MESSAGE_SIZE);
+            stats_.CountOversizedMessage();
+            stats_.CountReset();
             ResetConnection();
             return;
         }
 
-        auto unwrapped_size = size - 4;
-        if (available < unwrapped_size)
+        // wait for the rest of the frame, it may arrive over several reads
+        if (available < size)
             return;
+        auto unwrapped_size = size - 4;
 
         auto message_buf = std::make_unique<char[]>(size);
         if (!recv_buf_.Skip(4) || !recv_buf_.Pop(message_buf.get(), unwrapped_size)) {
             logger_->Log("recv_buf_.Pop({}) failed", size);
+            stats_.CountReset();
             ResetConnection();
             return;
         }
 
+        if (capture_.IsOpen())
+            capture_.Append(BridgeCapture::Direction::RECEIVED, message_buf.get(), unwrapped_size, received_at_);
+
         messages::ProtobufMessage message;
-        if (message.ParseFromArray(message_buf.get(), unwrapped_size)) {
+        bool parsed;
+        {
+            TRACE_SCOPE("ParseMessage");
+            parsed = message.ParseFromArray(message_buf.get(), unwrapped_size);
+        }
+        if (parsed) {
+            stats_.CountIn(message, size);
             message_callback_(message);
         } else {
-            logger_->Log("receivedMessage.ParseFromArray failed");
+            logger_->LogRateLimited(0, "receivedMessage.ParseFromArray failed");
+            stats_.CountParseFailure();
+            stats_.CountReset();
             ResetConnection();
             return;
         }
     }
 }
 
-void BridgeTransport::SendBridgeMessage(const messages::ProtobufMessage& message) {
+void BridgeTransport::SendBridgeMessage(const messages::ProtobufMessage& message, std::optional<std::chrono::steady_clock::time_point> sampled_at) {
     if (!IsConnected())
         return;
+    TRACE_SCOPE("SerializeMessage");
 
-    uint32_t size = static_cast<uint32_t>(message.ByteSizeLong());
-    uint32_t wrapped_size = size + 4;
-
-    auto message_buf = std::make_unique<char[]>(wrapped_size);
-    message_buf.get()[0] = (wrapped_size >> 0) & 0xFF;
-    message_buf.get()[1] = (wrapped_size >> 8) & 0xFF;
-    message_buf.get()[2] = (wrapped_size >> 16) & 0xFF;
-    message_buf.get()[3] = (wrapped_size >> 24) & 0xFF;
-    message.SerializeToArray(message_buf.get() + 4, size);
+    std::unique_ptr<char[]> message_buf;
+    uint32_t wrapped_size = SerializeFrame(message, message_buf);
 
+    std::lock_guard<std::mutex> lock(send_mutex_);
     if (!send_buf_.Push(message_buf.get(), wrapped_size)) {
+        stats_.CountSendBufferFull();
+        stats_.CountReset();
         ResetConnection();
         return;
     }
+    // only frames that are sent, in the order they are sent
+    if (capture_.IsOpen())
+        capture_.Append(BridgeCapture::Direction::SENT, message_buf.get() + 4, wrapped_size - 4, std::chrono::steady_clock::now());
+    stats_.CountOut(message, wrapped_size);
+    stats_.UpdateSendHighWater(send_buf_.BytesAvailable());
+    if (sampled_at && !oldest_unwritten_sample_)
+        oldest_unwritten_sample_ = sampled_at;
 
     write_signal_handle_->send();
 }
 
+uint32_t BridgeTransport::SerializeFrame(const messages::ProtobufMessage& message, std::unique_ptr<char[]>& frame_buf) {
+    uint32_t size = static_cast<uint32_t>(message.ByteSizeLong());
+    uint32_t wrapped_size = size + 4;
+
+    frame_buf = std::make_unique<char[]>(wrapped_size);
+    frame_buf.get()[0] = (wrapped_size >> 0) & 0xFF;
+    frame_buf.get()[1] = (wrapped_size >> 8) & 0xFF;
+    frame_buf.get()[2] = (wrapped_size >> 16) & 0xFF;
+    frame_buf.get()[3] = (wrapped_size >> 24) & 0xFF;
+    message.SerializeToArray(frame_buf.get() + 4, size);
+    return wrapped_size;
+}
+
 void BridgeTransport::SendWrites() {
     if (!IsConnected())
         return;
+    TRACE_SCOPE("WriteMessages");
 
-    auto available = send_buf_.BytesAvailable();
-    if (!available)
-        return;
+    std::unique_ptr<char[]> write_buf;
+    size_t available;
+    std::optional<std::chrono::steady_clock::time_point> sampled_at;
+    {
+        // taken together with the buffer contents, so the sample time belongs to a message in this write
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        available = send_buf_.BytesAvailable();
+        if (!available)
+            return;
 
-    auto write_buf = std::make_unique<char[]>(available);
-    send_buf_.Pop(write_buf.get(), available);
-    connection_handle_->write(write_buf.get(), static_cast<unsigned int>(available));
+        write_buf = std::make_unique<char[]>(available);
+        send_buf_.Pop(write_buf.get(), available);
+        sampled_at = std::exchange(oldest_unwritten_sample_, std::nullopt);
+    }
+    Write(std::move(write_buf), available);
+    if (sampled_at)
+        write_latency_.Record(std::chrono::steady_clock::now() - *sampled_at);
 }
\ No newline at end of file
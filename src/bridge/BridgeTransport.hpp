@@ -22,15 +22,21 @@
 */
 #pragma once
 
+#include <chrono>
 #include <filesystem>
+#include <mutex>
 #include <optional>
 #include <stdint.h>
 #include <thread>
 #include <uvw.hpp>
 
+#include "BridgeCapture.hpp"
+#include "BridgeStats.hpp"
 #include "CircularBuffer.hpp"
+#include "LatencyHistogram.hpp"
 #include "Logger.hpp"
 #include "ProtobufMessages.pb.h"
+#include "Trace.hpp"
 
 #define VRBRIDGE_MAX_MESSAGE_SIZE 1024
 #define VRBRIDGE_BUFFERS_SIZE 8192
@@ -94,11 +100,21 @@ public:
     /**
      * @brief Sends a message over the channel.
      *
-     * Queues the message to the send buffer to be sent over the pipe.
+     * Queues the message to the send buffer to be sent over the pipe. Safe to call from multiple threads.
      *
      * @param message The message to send.
+     * @param sampled_at Time the data in the message was sampled, if it should count towards the write latency.
      */
-    void SendBridgeMessage(const messages::ProtobufMessage& message);
+    void SendBridgeMessage(const messages::ProtobufMessage& message, std::optional<std::chrono::steady_clock::time_point> sampled_at = std::nullopt);
+
+    /**
+     * @brief Serializes a message into a frame as it is written to the pipe, prefixed with its little endian length.
+     *
+     * @param message The message to serialize.
+     * @param frame_buf Receives the frame.
+     * @return The size of the frame including the length prefix.
+     */
+    static uint32_t SerializeFrame(const messages::ProtobufMessage& message, std::unique_ptr<char[]>& frame_buf);
 
     /**
      * @brief Checks if the channel is connected.
@@ -109,6 +125,54 @@ public:
         return connected_;
     };
 
+    /**
+     * @brief Returns the time the data being parsed was read from the pipe.
+     *
+     * Only meaningful from the message callback, which runs on the event loop thread.
+     */
+    std::chrono::steady_clock::time_point GetReceivedAt() const {
+        return received_at_;
+    }
+
+    /**
+     * @brief Returns the latency from sampling data to writing it to the pipe.
+     *
+     * Counts the oldest sampled message of every write.
+     */
+    const SlimeVRDriver::LatencyHistogram& GetWriteLatency() const {
+        return write_latency_;
+    }
+
+    /**
+     * @brief Returns the traffic and health counters of the channel. Safe to read from any thread.
+     */
+    const BridgeStats& GetStats() const {
+        return stats_;
+    }
+
+    /**
+     * @brief Starts recording every frame read and queued for writing to a capture file, see `BridgeCapture`.
+     *
+     * Must be called before `Start()`.
+     *
+     * @param max_bytes Maximum size of the capture, later frames are dropped.
+     * @return false if the capture file couldn't be created.
+     */
+    bool StartCapture(const fs::path& path, size_t max_bytes) {
+        return capture_.Open(path, max_bytes);
+    }
+
+    /**
+     * @brief Finishes the capture file. Must be called after `Stop()`.
+     */
+    void StopCapture() {
+        capture_.Close();
+    }
+
+    const BridgeCapture& GetCapture() const {
+        return capture_;
+    }
+
 protected:
     virtual void CreateConnection() = 0;
     virtual void ResetConnection() = 0;
@@ -116,6 +180,17 @@ protected:
     void ResetBuffers();
     void OnConnect();
     void OnRecv(const uvw::data_event& event);
+
+    /**
+     * @brief Writes queued messages to the connection, from the event loop thread. The handle owns the data until the
+     * write completed.
+     *
+     * Overridden by test servers to impair the connection.
+     */
+    virtual void Write(std::unique_ptr<char[]> data, size_t size) {
+        connection_handle_->write(std::move(data), static_cast<unsigned int>(size));
+    }
+
     auto GetLoop() {
         return loop_;
     }
@@ -151,6 +226,7 @@ protected:
     }
 
     std::shared_ptr<Logger> logger_;
+    BridgeStats stats_;
     std::atomic<bool> connected_ = false;
     std::shared_ptr<uvw::pipe_handle> connection_handle_ = nullptr;
 
@@ -158,8 +234,15 @@ private:
     void RunThread();
     void SendWrites();
 
+    // send_buf_ has a single producer, senders on different threads take turns
+    std::mutex send_mutex_;
     CircularBuffer send_buf_;
+    // sample time of the oldest message in send_buf_, guarded by send_mutex_
+    std::optional<std::chrono::steady_clock::time_point> oldest_unwritten_sample_;
+    SlimeVRDriver::LatencyHistogram write_latency_;
+    BridgeCapture capture_;
     CircularBuffer recv_buf_;
+    std::chrono::steady_clock::time_point received_at_{};
     std::shared_ptr<uvw::async_handle> stop_signal_handle_ = nullptr;
     std::shared_ptr<uvw::async_handle> write_signal_handle_ = nullptr;
     std::unique_ptr<std::thread> thread_ = nullptr;
@@ -0,0 +1,56 @@
+#include "AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t thread_allocation_count = 0;
+
+uint64_t GetThreadAllocationCount() {
+    return thread_allocation_count;
+}
+
+// The array and nothrow forms forward to these by default
+void* operator new(std::size_t size) {
+    thread_allocation_count++;
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    thread_allocation_count++;
+    auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    if (void* ptr = _aligned_malloc(size ? size : 1, align))
+        return ptr;
+#else
+    // aligned_alloc wants a multiple of the alignment
+    if (void* ptr = std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align))
+        return ptr;
+#endif
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
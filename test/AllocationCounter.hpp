@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Returns the number of heap allocations the calling thread made through operator new so far.
+ * Linking AllocationCounter.cpp replaces the global operator new and delete to count them. It lives next to the unit
+ * tests rather than in test/common, so the benchmarks keep the default allocator.
+ */
+uint64_t GetThreadAllocationCount();
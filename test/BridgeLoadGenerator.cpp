@@ -0,0 +1,316 @@
+#include "BridgeLoadGenerator.hpp"
+
+#include <algorithm>
+#include <format>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <simdjson.h>
+
+#include "TrackerRole.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace std::chrono;
+
+namespace {
+
+#ifdef _WIN32
+double FileTimeSeconds(const FILETIME& time) {
+    return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1e7;
+}
+#endif
+
+double ProcessCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    return FileTimeSeconds(kernel) + FileTimeSeconds(user);
+#else
+    timespec time{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+#endif
+}
+
+double ThreadCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    return FileTimeSeconds(kernel) + FileTimeSeconds(user);
+#else
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+#endif
+}
+
+struct DriverCounters {
+    uint64_t positions = 0;
+    uint64_t parse_failures = 0;
+    uint64_t recv_buffer_full = 0;
+    uint64_t resets = 0;
+    uint64_t reconnects = 0;
+};
+
+// reads the counters from the driver's "bridge" debug request, the totals since the driver started
+DriverCounters ParseDriverCounters(const std::string& json) {
+    DriverCounters counters;
+    simdjson::ondemand::parser parser;
+    simdjson::padded_string padded(json);
+    simdjson::ondemand::document doc = parser.iterate(padded);
+    auto read = [&](const char* key, uint64_t& out) {
+        uint64_t value;
+        if (!doc[key].get_uint64().get(value))
+            out = value;
+    };
+    uint64_t positions;
+    if (!doc["in"]["position"]["messages"].get_uint64().get(positions))
+        counters.positions = positions;
+    read("parse_failures", counters.parse_failures);
+    read("recv_buffer_full", counters.recv_buffer_full);
+    read("resets", counters.resets);
+    read("reconnects", counters.reconnects);
+    return counters;
+}
+
+} // namespace
+
+std::string BridgeLoadGenerator::Report::ToJson() const {
+    return std::format(
+        R"({{"elapsed_ms":{},"positions_sent":{},"positions_skipped":{},"positions_submitted":{},"dropped":{},)"
+        R"("churn_messages":{},"drops_requested":{},"disconnects":{},"driver_positions_received":{},"driver_parse_failures":{},)"
+        R"("driver_recv_buffer_full":{},"driver_resets":{},"driver_reconnects":{},"server_resets":{},)"
+        R"("cpu_us_per_message":{:.2f},"latency":{{"count":{},"mean_us":{:.1f},"p50_us":{},"p90_us":{},"p99_us":{},"p999_us":{},"max_us":{}}},)"
+        R"("max_recovery_ms":{}}})",
+        duration_cast<milliseconds>(elapsed).count(),
+        positions_sent,
+        positions_skipped,
+        positions_submitted,
+        Dropped(),
+        churn_messages,
+        drops_requested,
+        disconnects,
+        driver_positions_received,
+        driver_parse_failures,
+        driver_recv_buffer_full,
+        driver_resets,
+        driver_reconnects,
+        server_resets,
+        cpu_us_per_message,
+        latency.count,
+        latency.mean_us,
+        latency.p50_us,
+        latency.p90_us,
+        latency.p99_us,
+        latency.p999_us,
+        latency.max_us,
+        duration_cast<milliseconds>(max_recovery).count());
+}
+
+BridgeLoadGenerator::BridgeLoadGenerator(BridgeServerMock& server, SlimeVRDriver::VRDriver& driver, Config config)
+    : server_(server)
+    , driver_(driver)
+    , config_(config) {
+    // room for every position of the run with jitter, plus some to spare
+    capacity_ = static_cast<size_t>(config_.trackers * config_.rate_hz * duration<double>(config_.duration).count() * 1.1) + config_.trackers + 1;
+    sent_at_ = std::make_unique<std::atomic<int64_t>[]>(capacity_);
+}
+
+std::string BridgeLoadGenerator::GetSerial(int tracker_id) {
+    return std::format("load://{}", tracker_id);
+}
+
+void BridgeLoadGenerator::AddTrackers() {
+    SendTrackers(0, config_.trackers);
+}
+
+void BridgeLoadGenerator::SendTrackers(int first, int count) {
+    messages::ProtobufMessage message;
+    for (int id = first; id < first + count; id++) {
+        auto* tracker_added = message.mutable_tracker_added();
+        tracker_added->set_tracker_id(id);
+        tracker_added->set_tracker_role(TrackerRole::WAIST);
+        tracker_added->set_tracker_serial(GetSerial(id));
+        tracker_added->set_tracker_name(GetSerial(id));
+        server_.SendBridgeMessage(message);
+        SendStatus(id, messages::TrackerStatus_Status_OK);
+    }
+}
+
+void BridgeLoadGenerator::SendStatus(int tracker_id, messages::TrackerStatus_Status status) {
+    messages::ProtobufMessage message;
+    auto* tracker_status = message.mutable_tracker_status();
+    tracker_status->set_tracker_id(tracker_id);
+    tracker_status->set_status(status);
+    server_.SendBridgeMessage(message);
+}
+
+void BridgeLoadGenerator::SendPosition(int tracker_id, uint32_t sequence) {
+    messages::ProtobufMessage message;
+    auto* position = message.mutable_position();
+    position->set_tracker_id(tracker_id);
+    position->set_data_source(messages::Position_DataSource_FULL);
+    position->set_x(static_cast<float>(sequence));
+    position->set_y(1.f);
+    position->set_z(0.f);
+    position->set_qw(1.f);
+    position->set_qx(0.f);
+    position->set_qy(0.f);
+    position->set_qz(0.f);
+    sent_at_[sequence].store(steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    server_.SendBridgeMessage(message);
+}
+
+void BridgeLoadGenerator::OnPoseSubmitted(const vr::DriverPose_t& pose) {
+    auto now = steady_clock::now().time_since_epoch().count();
+    auto sequence = static_cast<size_t>(pose.vecPosition[0]);
+    if (sequence == 0 || sequence >= capacity_)
+        return;
+    // a pose submitted again by the frame or thread submission modes only counts once
+    int64_t sent_at = sent_at_[sequence].exchange(0, std::memory_order_relaxed);
+    if (!sent_at)
+        return;
+    latency_.Record(steady_clock::duration(now - sent_at));
+    submitted_++;
+    if (sequence >= recover_from_.load(std::memory_order_relaxed)) {
+        int64_t not_recovered = 0;
+        recovered_at_.compare_exchange_strong(not_recovered, now, std::memory_order_relaxed);
+    }
+}
+
+BridgeLoadGenerator::Report BridgeLoadGenerator::Run() {
+    Report report;
+    auto driver_before = ParseDriverCounters(driver_.DebugRequest("bridge"));
+    auto server_before = server_.GetStats().TakeSnapshot();
+    double process_cpu_before = ProcessCpuSeconds();
+    double thread_cpu_before = ThreadCpuSeconds();
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> jitter(-config_.jitter, config_.jitter);
+    auto period = duration_cast<steady_clock::duration>(duration<double>(1.0 / config_.rate_hz));
+
+    auto start = steady_clock::now();
+    auto end = start + config_.duration;
+    // trackers are spread over the period, like IMUs that aren't synchronised
+    std::vector<steady_clock::time_point> nominal(config_.trackers);
+    std::vector<steady_clock::time_point> due(config_.trackers);
+    for (int id = 0; id < config_.trackers; id++) {
+        nominal[id] = start + period * id / config_.trackers;
+        due[id] = nominal[id];
+    }
+    auto never = steady_clock::time_point::max();
+    auto next_churn = config_.churn_interval.count() ? start + config_.churn_interval : never;
+    auto next_drop_burst = config_.reconnect_interval.count() ? start + config_.reconnect_interval : never;
+    int churn_cursor = 0;
+    int drops_left = 0;
+    std::optional<steady_clock::time_point> dropped_at;
+    bool was_connected = server_.IsConnected();
+    // the drop is done on the server's IO thread, the old connection doesn't count until it was closed
+    bool dropping = false;
+    uint32_t sequence = 1;
+
+    auto now = start;
+    while (now < end) {
+        bool connected = server_.IsConnected();
+        if (dropping) {
+            dropping = connected;
+            connected = false;
+        }
+        if (connected && !was_connected)
+            AddTrackers();
+        if (!connected && was_connected) {
+            report.disconnects++;
+            // lost without a drop of ours, like an impaired connection cut by the server
+            if (!dropped_at) {
+                recovered_at_ = 0;
+                recover_from_ = sequence;
+                dropped_at = now;
+            }
+        }
+        was_connected = connected;
+
+        if (now >= next_drop_burst) {
+            drops_left = config_.reconnect_storm;
+            next_drop_burst = never;
+        }
+        if (drops_left && connected) {
+            server_.DropConnection();
+            drops_left--;
+            report.drops_requested++;
+            recovered_at_ = 0;
+            recover_from_ = sequence;
+            if (!dropped_at)
+                dropped_at = now;
+            // wait for the driver to reconnect before the next drop of the storm
+            dropping = true;
+            connected = false;
+        }
+        if (dropped_at && !drops_left && recovered_at_) {
+            steady_clock::time_point recovered_at{ steady_clock::duration(recovered_at_.load()) };
+            report.max_recovery = std::max(report.max_recovery, recovered_at - *dropped_at);
+            dropped_at.reset();
+            recover_from_ = UINT32_MAX;
+            if (config_.reconnect_interval.count())
+                next_drop_burst = now + config_.reconnect_interval;
+        }
+
+        if (now >= next_churn) {
+            for (int i = 0; i < config_.churn_trackers && connected; i++) {
+                int id = churn_cursor++ % config_.trackers;
+                SendStatus(id, messages::TrackerStatus_Status_DISCONNECTED);
+                SendTrackers(id, 1);
+                report.churn_messages += 3;
+            }
+            next_churn += config_.churn_interval;
+        }
+
+        auto next_due = never;
+        for (int id = 0; id < config_.trackers; id++) {
+            if (due[id] <= now) {
+                if (connected && sequence < capacity_) {
+                    SendPosition(id, sequence++);
+                    report.positions_sent++;
+                } else {
+                    report.positions_skipped++;
+                }
+                nominal[id] += period;
+                due[id] = nominal[id] + duration_cast<steady_clock::duration>(period * jitter(rng));
+            }
+            next_due = std::min(next_due, due[id]);
+        }
+        // wakes up at least every millisecond to follow the connection
+        std::this_thread::sleep_until(std::min({ next_due, next_churn, next_drop_burst, end, now + 1ms }));
+        now = steady_clock::now();
+    }
+    report.elapsed = now - start;
+    double generator_cpu = ThreadCpuSeconds() - thread_cpu_before;
+
+    // positions in flight
+    auto drain_deadline = steady_clock::now() + 500ms;
+    while (submitted_ < report.positions_sent && steady_clock::now() < drain_deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    double process_cpu = ProcessCpuSeconds() - process_cpu_before;
+
+    auto driver_after = ParseDriverCounters(driver_.DebugRequest("bridge"));
+    auto server_after = server_.GetStats().TakeSnapshot();
+    report.positions_submitted = submitted_;
+    report.driver_positions_received = driver_after.positions - driver_before.positions;
+    report.driver_parse_failures = driver_after.parse_failures - driver_before.parse_failures;
+    report.driver_recv_buffer_full = driver_after.recv_buffer_full - driver_before.recv_buffer_full;
+    report.driver_resets = driver_after.resets - driver_before.resets;
+    report.driver_reconnects = driver_after.reconnects - driver_before.reconnects;
+    report.server_resets = server_after.resets - server_before.resets;
+    if (report.positions_sent)
+        report.cpu_us_per_message = (process_cpu - generator_cpu) * 1e6 / report.positions_sent;
+    report.latency = latency_.Summarize();
+    return report;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <openvr_driver.h>
+
+#include "BridgeServerMock.hpp"
+#include "LatencyHistogram.hpp"
+#include "VRDriver.hpp"
+
+/**
+ * Plays SlimeVR Server under load against a running driver, to find where the bridge stops keeping up.
+ *
+ * Streams positions of many trackers through a `BridgeServerMock`, optionally with churn of tracker adds and status
+ * changes and with the connection dropped in bursts. The x of every position is its sequence number, poses the driver
+ * submits are passed to `OnPoseSubmitted` to tell which positions made it through and how long they took.
+ */
+class BridgeLoadGenerator {
+public:
+    struct Config {
+        // trackers with ids 0 to trackers - 1, OpenVR has room for about 60 next to a headset
+        int trackers = 10;
+        // positions per second of every tracker
+        double rate_hz = 100.0;
+        // every position is sent up to this fraction of the period early or late, at random
+        double jitter = 0.0;
+        std::chrono::milliseconds duration{ 1000 };
+        // every interval, this many trackers are re-added and go through a disconnect and back to OK
+        std::chrono::milliseconds churn_interval{ 0 };
+        int churn_trackers = 0;
+        // after every interval, the connection is dropped this many times in a row, each time right after the driver
+        // reconnected. The interval starts over once positions flow again.
+        std::chrono::milliseconds reconnect_interval{ 0 };
+        int reconnect_storm = 1;
+    };
+
+    struct Report {
+        std::chrono::steady_clock::duration elapsed{};
+        uint64_t positions_sent = 0;
+        // while the driver wasn't connected
+        uint64_t positions_skipped = 0;
+        uint64_t positions_submitted = 0;
+        uint64_t churn_messages = 0;
+        uint64_t drops_requested = 0;
+        // times the connection was seen going down, by a drop or otherwise
+        uint64_t disconnects = 0;
+        // counters of the driver's side of the bridge during the run
+        uint64_t driver_positions_received = 0;
+        uint64_t driver_parse_failures = 0;
+        uint64_t driver_recv_buffer_full = 0;
+        uint64_t driver_resets = 0;
+        uint64_t driver_reconnects = 0;
+        uint64_t server_resets = 0;
+        // CPU time of the whole process per position sent, less the generator's own thread. Includes the mock
+        // server's IO thread, so compare runs rather than taking it as the driver's cost.
+        double cpu_us_per_message = 0.0;
+        // from sending a position to the driver submitting it
+        SlimeVRDriver::LatencyHistogram::Summary latency;
+        // longest time from the first drop of a storm, or from the connection going down on its own, to the submission
+        // of a position sent once it was back
+        std::chrono::steady_clock::duration max_recovery{};
+
+        uint64_t Dropped() const {
+            return positions_sent - positions_submitted;
+        }
+
+        std::string ToJson() const;
+    };
+
+    /**
+     * @param driver Initialised driver, connected to `server`.
+     */
+    BridgeLoadGenerator(BridgeServerMock& server, SlimeVRDriver::VRDriver& driver, Config config);
+
+    /**
+     * Sends TrackerAdded and an OK status for every tracker, like the server does for a new connection. `Run` sends
+     * them again whenever the driver reconnected.
+     */
+    void AddTrackers();
+
+    /**
+     * Call for every pose the driver submits, from any thread. See `FakeDriverContext::SetPoseObserver`.
+     */
+    void OnPoseSubmitted(const vr::DriverPose_t& pose);
+
+    /**
+     * Generates the load for the configured duration, then waits briefly for positions still in flight.
+     */
+    Report Run();
+
+    /**
+     * Returns the serial the trackers are added with.
+     */
+    static std::string GetSerial(int tracker_id);
+
+private:
+    void SendTrackers(int first, int count);
+    void SendPosition(int tracker_id, uint32_t sequence);
+    void SendStatus(int tracker_id, messages::TrackerStatus_Status status);
+
+    BridgeServerMock& server_;
+    SlimeVRDriver::VRDriver& driver_;
+    Config config_;
+
+    // send time of every sequence number, zeroed once the position was submitted
+    size_t capacity_ = 0;
+    std::unique_ptr<std::atomic<int64_t>[]> sent_at_;
+    std::atomic<uint64_t> submitted_ = 0;
+    // first sequence number sent after the last drop, and when a position from there on was submitted
+    std::atomic<uint32_t> recover_from_ = UINT32_MAX;
+    std::atomic<int64_t> recovered_at_ = 0;
+    SlimeVRDriver::LatencyHistogram latency_;
+};
@@ -0,0 +1,57 @@
+#include "BridgeReplay.hpp"
+
+#include <format>
+#include <optional>
+#include <thread>
+
+#include "AllocationCounter.hpp"
+
+std::string BridgeReplay::Result::ToJson() const {
+    return std::format(
+        R"({{"messages":{},"bytes":{},"parse_failures":{},"elapsed_s":{:.3f},"messages_per_s":{:.0f},"allocations_per_message":{:.2f},"handle_latency":{},"lateness":{}}})",
+        messages,
+        bytes,
+        parse_failures,
+        elapsed.count(),
+        MessagesPerSecond(),
+        messages ? static_cast<double>(allocations) / messages : 0.0,
+        handle_latency.ToJson(),
+        lateness.ToJson());
+}
+
+bool BridgeReplay::Load(const std::filesystem::path& path) {
+    return BridgeCapture::Read(path, data_, records_);
+}
+
+void BridgeReplay::Run(const std::function<void(const messages::ProtobufMessage&)>& handler, Result& result, double speed, BridgeCapture::Direction direction) const {
+    using namespace std::chrono;
+
+    messages::ProtobufMessage message;
+    std::optional<nanoseconds> first_timestamp;
+    uint64_t allocations_before = GetThreadAllocationCount();
+    auto start = steady_clock::now();
+    for (const auto& record : records_) {
+        if (record.direction != direction)
+            continue;
+
+        if (speed != kMaxSpeed) {
+            if (!first_timestamp)
+                first_timestamp = record.timestamp;
+            auto due = start + duration_cast<steady_clock::duration>((record.timestamp - *first_timestamp) / speed);
+            std::this_thread::sleep_until(due);
+            result.lateness.Record(steady_clock::now() - due);
+        }
+
+        if (!message.ParseFromArray(record.payload.data(), static_cast<int>(record.payload.size()))) {
+            result.parse_failures++;
+            continue;
+        }
+        auto handle_start = steady_clock::now();
+        handler(message);
+        result.handle_latency.Record(steady_clock::now() - handle_start);
+        result.messages++;
+        result.bytes += record.payload.size() + 4;
+    }
+    result.elapsed += steady_clock::now() - start;
+    result.allocations += GetThreadAllocationCount() - allocations_before;
+}
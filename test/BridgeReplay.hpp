@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+#include "ProtobufMessages.pb.h"
+#include "bridge/BridgeCapture.hpp"
+
+/**
+ * Feeds the frames of a bridge capture to a message handler, e.g. VRDriver::OnBridgeMessage or the
+ * SendBridgeMessage of a BridgeServerMock, to benchmark the driver with recorded traffic.
+ *
+ * Frames are parsed and handed over on the calling thread, either at their recorded times scaled by a speed factor or
+ * as fast as possible.
+ */
+class BridgeReplay {
+public:
+    // speed that replays as fast as possible
+    static constexpr double kMaxSpeed = 0.0;
+
+    struct Result {
+        uint64_t messages = 0;
+        uint64_t bytes = 0;
+        uint64_t parse_failures = 0;
+        std::chrono::duration<double> elapsed{};
+        // time spent in the handler per message
+        SlimeVRDriver::LatencyHistogram handle_latency;
+        // how much later than scheduled messages were handed over, only with a speed
+        SlimeVRDriver::LatencyHistogram lateness;
+        // made by parsing and handling on the replay thread
+        uint64_t allocations = 0;
+
+        double MessagesPerSecond() const {
+            return elapsed.count() > 0.0 ? messages / elapsed.count() : 0.0;
+        }
+
+        std::string ToJson() const;
+    };
+
+    /**
+     * Loads a capture file.
+     *
+     * @return false if it couldn't be read.
+     */
+    bool Load(const std::filesystem::path& path);
+
+    /**
+     * Replays the frames in one direction.
+     *
+     * @param result Receives the statistics of the run, adding to any earlier runs.
+     * @param speed Multiple of the recorded speed, kMaxSpeed for as fast as possible.
+     * @param direction RECEIVED replays what the driver read from the server.
+     */
+    void Run(const std::function<void(const messages::ProtobufMessage&)>& handler, Result& result, double speed = 1.0, BridgeCapture::Direction direction = BridgeCapture::Direction::RECEIVED) const;
+
+    const std::vector<BridgeCapture::Record>& GetRecords() const {
+        return records_;
+    }
+
+private:
+    std::vector<char> data_;
+    std::vector<BridgeCapture::Record> records_;
+};
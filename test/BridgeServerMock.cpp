@@ -22,31 +22,52 @@
 */
 #include "BridgeServerMock.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace std::literals::chrono_literals;
+using std::chrono::steady_clock;
 
 void BridgeServerMock::CreateConnection() {
     std::string path = GetBridgePath();
 
     logger_->Log("[{}] listening", path);
 
+    drop_signal_handle_ = GetLoop()->resource<uvw::async_handle>();
+    drop_signal_handle_->on<uvw::async_event>([this](const uvw::async_event&, uvw::async_handle&) {
+        CloseClient();
+    });
+
+    if (impairment_.IsEnabled()) {
+        // held back writes are released on a tick, like a slow link would
+        impairment_timer_ = GetLoop()->resource<uvw::timer_handle>();
+        impairment_timer_->on<uvw::timer_event>([this](const uvw::timer_event&, uvw::timer_handle&) {
+            WriteImpaired();
+        });
+        impairment_timer_->start(1ms, 1ms);
+        next_stall_at_ = steady_clock::now() + impairment_.stall_every;
+    }
+
     server_handle_ = GetLoop()->resource<uvw::pipe_handle>(false);
     server_handle_->on<uvw::listen_event>([this, path](const uvw::listen_event& event, uvw::pipe_handle&) {
         logger_->Log("[{}] new client", path);
+        CloseClient();
         ResetBuffers();
+        written_bytes_ = 0;
 
         /* ipc = false -> pipe will be used for handle passing between processes? no */
         connection_handle_ = GetLoop()->resource<uvw::pipe_handle>(false);
 
         connection_handle_->on<uvw::end_event>([this, path](const uvw::end_event&, uvw::pipe_handle&) {
             logger_->Log("[{}] disconnected", path);
-            StopAsync();
+            CloseClient();
         });
         connection_handle_->on<uvw::data_event>([this](const uvw::data_event& event, uvw::pipe_handle&) {
             OnRecv(event);
         });
         connection_handle_->on<uvw::error_event>([this, path](const uvw::error_event& event, uvw::pipe_handle&) {
             logger_->Log("[{}] pipe error: {}", path, event.what());
-            StopAsync();
+            CloseClient();
         });
 
         server_handle_->accept(*connection_handle_);
@@ -63,14 +84,108 @@ void BridgeServerMock::CreateConnection() {
     server_handle_->listen();
 }
 
+void BridgeServerMock::DropConnection() {
+    if (drop_signal_handle_ && !drop_signal_handle_->closing())
+        drop_signal_handle_->send();
+}
+
+void BridgeServerMock::Write(std::unique_ptr<char[]> data, size_t size) {
+    if (!impairment_.IsEnabled()) {
+        BridgeTransport::Write(std::move(data), size);
+        return;
+    }
+
+    auto due_at = steady_clock::now() + impairment_.delay;
+    if (impairment_.coalesce.count()) {
+        // everything written within an interval goes out together at its end
+        auto interval = std::chrono::duration_cast<steady_clock::duration>(impairment_.coalesce);
+        due_at += interval - due_at.time_since_epoch() % interval;
+    }
+    pending_writes_.push_back({ due_at, std::vector<char>(data.get(), data.get() + size) });
+    WriteImpaired();
+}
+
+void BridgeServerMock::WriteImpaired() {
+    if (!IsConnected()) {
+        pending_writes_.clear();
+        return;
+    }
+
+    auto now = steady_clock::now();
+    if (impairment_.stall_every.count() && now >= next_stall_at_) {
+        stalled_until_ = next_stall_at_ + impairment_.stall_for;
+        next_stall_at_ = stalled_until_ + impairment_.stall_every;
+    }
+    if (now < stalled_until_)
+        return;
+
+    while (!pending_writes_.empty() && pending_writes_.front().due_at <= now) {
+        if (impairment_.coalesce.count()) {
+            auto merged = std::move(pending_writes_.front());
+            pending_writes_.pop_front();
+            while (!pending_writes_.empty() && pending_writes_.front().due_at <= now) {
+                auto& next = pending_writes_.front().data;
+                merged.data.insert(merged.data.end(), next.begin(), next.end());
+                pending_writes_.pop_front();
+            }
+            pending_writes_.push_front(std::move(merged));
+        }
+        auto& write = pending_writes_.front();
+
+        size_t size = write.data.size();
+        if (impairment_.split_bytes && impairment_.split_gap.count())
+            size = std::min(size, impairment_.split_bytes);
+        if (impairment_.drop_after_bytes)
+            size = std::min(size, impairment_.drop_after_bytes - written_bytes_);
+
+        size_t piece_size = impairment_.split_bytes ? impairment_.split_bytes : size;
+        for (size_t offset = 0; offset < size; offset += piece_size) {
+            size_t piece = std::min(piece_size, size - offset);
+            auto piece_buf = std::make_unique<char[]>(piece);
+            std::memcpy(piece_buf.get(), write.data.data() + offset, piece);
+            BridgeTransport::Write(std::move(piece_buf), piece);
+        }
+        written_bytes_ += size;
+
+        if (impairment_.drop_after_bytes && written_bytes_ >= impairment_.drop_after_bytes) {
+            logger_->Log("[{}] dropping the connection after {} bytes", GetBridgePath(), written_bytes_);
+            impairment_drops_++;
+            pending_writes_.clear();
+            // the bytes written so far still reach the client, ending in the middle of a frame
+            connected_ = false;
+            connection_handle_->on<uvw::shutdown_event>([this](const uvw::shutdown_event&, uvw::pipe_handle&) {
+                CloseClient();
+            });
+            connection_handle_->shutdown();
+            return;
+        }
+
+        if (size < write.data.size()) {
+            write.data.erase(write.data.begin(), write.data.begin() + size);
+            write.due_at = now + impairment_.split_gap;
+        } else {
+            pending_writes_.pop_front();
+        }
+    }
+}
+
 void BridgeServerMock::ResetConnection() {
-    CloseConnectionHandles();
+    CloseClient();
 }
 
 void BridgeServerMock::CloseConnectionHandles() {
+    if (drop_signal_handle_)
+        drop_signal_handle_->close();
+    if (impairment_timer_)
+        impairment_timer_->close();
     if (server_handle_)
         server_handle_->close();
-    if (connection_handle_)
-        connection_handle_->close();
+    CloseClient();
+}
+
+void BridgeServerMock::CloseClient() {
     connected_ = false;
+    pending_writes_.clear();
+    if (connection_handle_ && !connection_handle_->closing())
+        connection_handle_->close();
 }
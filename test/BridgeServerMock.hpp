@@ -22,19 +22,92 @@
 */
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <stdint.h>
 #include <uvw.hpp>
+#include <vector>
 
 #include "bridge/BridgeTransport.hpp"
 
+/**
+ * Stands in for SlimeVR Server, listening on the bridge path. Keeps listening when a client disconnects or is dropped,
+ * so a driver can reconnect to it.
+ *
+ * What the server writes can be impaired, to exercise the client on a connection that is worse than a local socket.
+ */
 class BridgeServerMock : public BridgeTransport {
 public:
+    /**
+     * Ways to impair the writes of the server, all off by default. They combine, delays and coalescing apply before
+     * the data is split.
+     */
+    struct Impairment {
+        // written in pieces of at most this many bytes, so frames arrive over several reads
+        size_t split_bytes = 0;
+        // time between the pieces of a split write, with 0 they are written right after each other
+        std::chrono::milliseconds split_gap{ 0 };
+        // writes are held back and written together every interval, many frames in one read
+        std::chrono::milliseconds coalesce{ 0 };
+        // every write is delayed by this long
+        std::chrono::milliseconds delay{ 0 };
+        // nothing is written for stall_for after every stall_every
+        std::chrono::milliseconds stall_every{ 0 };
+        std::chrono::milliseconds stall_for{ 0 };
+        // the connection is dropped once this many bytes were written on it, cutting the frame it ends in
+        size_t drop_after_bytes = 0;
+
+        bool IsEnabled() const {
+            return split_bytes || coalesce.count() || delay.count() || stall_every.count() || drop_after_bytes;
+        }
+    };
+
     using BridgeTransport::BridgeTransport;
 
+    /**
+     * Closes the connection to the current client, like a server restart would. Safe to call from any thread.
+     */
+    void DropConnection();
+
+    /**
+     * Impairs the writes of the server from now on. Must be called before `Start()`.
+     */
+    void SetImpairment(const Impairment& impairment) {
+        impairment_ = impairment;
+    }
+
+    /**
+     * Returns how many times the impairment dropped the connection. Safe to call from any thread.
+     */
+    uint64_t GetImpairmentDrops() const {
+        return impairment_drops_;
+    }
+
+protected:
+    void Write(std::unique_ptr<char[]> data, size_t size) override;
+
 private:
+    struct PendingWrite {
+        std::chrono::steady_clock::time_point due_at;
+        std::vector<char> data;
+    };
+
     void CreateConnection() override;
     void ResetConnection() override;
     void CloseConnectionHandles() override;
+    void CloseClient();
+    void WriteImpaired();
 
     std::shared_ptr<uvw::pipe_handle> server_handle_ = nullptr;
+    std::shared_ptr<uvw::async_handle> drop_signal_handle_ = nullptr;
+
+    Impairment impairment_;
+    // only used on the event loop thread
+    std::shared_ptr<uvw::timer_handle> impairment_timer_ = nullptr;
+    std::deque<PendingWrite> pending_writes_;
+    std::chrono::steady_clock::time_point next_stall_at_{};
+    std::chrono::steady_clock::time_point stalled_until_{};
+    size_t written_bytes_ = 0;
+    std::atomic<uint64_t> impairment_drops_ = 0;
 };
\ No newline at end of file
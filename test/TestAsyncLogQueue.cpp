@@ -0,0 +1,170 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncLogQueue.hpp"
+#include "Logger.hpp"
+#include "AllocationCounter.hpp"
+
+using SlimeVRDriver::AsyncLogQueue;
+
+namespace {
+
+class QueueLogger : public Logger {
+public:
+    QueueLogger(AsyncLogQueue& queue, const std::string& name)
+        : Logger(name)
+        , queue_(queue) { }
+
+protected:
+    void LogImpl(const char* message) override {
+        queue_.Push(message);
+    }
+
+private:
+    AsyncLogQueue& queue_;
+};
+
+} // namespace
+
+TEST_CASE("Messages from several threads are all written in order", "[AsyncLogQueue]") {
+    std::mutex written_mutex;
+    std::vector<std::string> written;
+    AsyncLogQueue queue([&](const char* message) {
+        std::lock_guard<std::mutex> lock(written_mutex);
+        written.emplace_back(message);
+    });
+    queue.Start();
+    REQUIRE(queue.IsRunning());
+
+    const int threads = 4;
+    const int messages = 20000;
+    std::atomic<uint64_t> rejected = 0;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; t++) {
+        producers.emplace_back([&, t]() {
+            for (int i = 0; i < messages; i++) {
+                std::string message = std::format("{}: {}", t, i);
+                // retry dropped messages so all of them arrive
+                while (!queue.Push(message.c_str())) {
+                    rejected++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    queue.Stop();
+    REQUIRE_FALSE(queue.IsRunning());
+    REQUIRE(queue.GetDroppedCount() == rejected);
+
+    // messages of one thread keep their order
+    std::vector<int> next(threads, 0);
+    uint64_t reported = 0;
+    for (const auto& message : written) {
+        if (message.ends_with(" log messages dropped")) {
+            reported += std::stoull(message);
+            continue;
+        }
+        int t = message[0] - '0';
+        REQUIRE(message == std::format("{}: {}", t, next[t]));
+        next[t]++;
+    }
+    REQUIRE(next == std::vector<int>(threads, messages));
+    REQUIRE(reported == rejected);
+}
+
+TEST_CASE("Full queue drops messages and reports them", "[AsyncLogQueue]") {
+    std::atomic<bool> writing = false;
+    std::atomic<bool> blocked = true;
+    std::vector<std::string> written;
+    AsyncLogQueue queue([&](const char* message) {
+        writing = true;
+        // a sink stalled like a slow vrserver
+        while (blocked) {
+            std::this_thread::yield();
+        }
+        written.emplace_back(message);
+    });
+    queue.Start();
+
+    REQUIRE(queue.Push("first"));
+    while (!writing) {
+        std::this_thread::yield();
+    }
+    // "first" keeps its slot until the sink returned
+    size_t accepted = 0;
+    while (accepted < AsyncLogQueue::kCapacity && queue.Push(std::to_string(accepted).c_str())) {
+        accepted++;
+    }
+    for (int i = 0; i < 9; i++) {
+        queue.Push("dropped");
+    }
+    blocked = false;
+    queue.Stop();
+
+    REQUIRE(accepted == AsyncLogQueue::kCapacity - 1);
+    REQUIRE(queue.GetDroppedCount() == 10);
+    REQUIRE(written.size() == AsyncLogQueue::kCapacity + 1);
+    REQUIRE(written.front() == "first");
+    REQUIRE(written[accepted] == std::to_string(accepted - 1));
+    REQUIRE(written.back() == "10 log messages dropped");
+}
+
+TEST_CASE("An idle writer wakes up for new messages and to stop", "[AsyncLogQueue]") {
+    std::atomic<int> written = 0;
+    AsyncLogQueue queue([&](const char* message) { written++; });
+    queue.Start();
+
+    for (int i = 1; i <= 3; i++) {
+        // long enough for the writer to block on the empty queue
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(queue.Push("message"));
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (written < i && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        REQUIRE(written == i);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.Stop();
+    REQUIRE_FALSE(queue.IsRunning());
+    REQUIRE(written == 3);
+    REQUIRE(queue.GetDroppedCount() == 0);
+}
+
+TEST_CASE("Logging to the queue doesn't allocate", "[AsyncLogQueue]") {
+    std::vector<std::string> written;
+    AsyncLogQueue queue([&](const char* message) { written.emplace_back(message); });
+    QueueLogger logger(queue, "Tracker");
+    std::string serial = "human://WAIST";
+    std::string long_message(AsyncLogQueue::kMaxMessageLength * 2, 'x');
+
+    // make sure allocations are counted at all
+    uint64_t allocations_before = GetThreadAllocationCount();
+    auto probe = std::make_unique<int>(0);
+    REQUIRE(GetThreadAllocationCount() == allocations_before + 1);
+
+    allocations_before = GetThreadAllocationCount();
+    logger.Log("{} ({}) at {:.3f}", serial, 42, 1.5);
+    logger.Log("{}", long_message);
+    REQUIRE(GetThreadAllocationCount() == allocations_before);
+
+    queue.Start();
+    queue.Stop();
+    REQUIRE(written.size() == 2);
+    REQUIRE(written[0] == "Tracker: human://WAIST (42) at 1.500");
+    // truncated
+    REQUIRE(written[1].size() == AsyncLogQueue::kMaxMessageLength);
+    REQUIRE(written[1].starts_with("Tracker: xxx"));
+}
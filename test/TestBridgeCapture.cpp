@@ -0,0 +1,167 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bridge/BridgeCapture.hpp"
+
+using namespace std::chrono;
+
+namespace {
+
+std::filesystem::path CapturePath(const char* name) {
+    return std::filesystem::temp_directory_path() / name;
+}
+
+} // namespace
+
+TEST_CASE("Captured frames are read back", "[BridgeCapture]") {
+    auto path = CapturePath("slimevr_test_capture.bin");
+    BridgeCapture capture;
+    REQUIRE(capture.Open(path, 1 << 20));
+
+    auto start = steady_clock::now();
+    std::string position = "position payload";
+    std::string empty;
+    REQUIRE(capture.Append(BridgeCapture::Direction::RECEIVED, position.data(), static_cast<uint32_t>(position.size()), start + milliseconds(1)));
+    REQUIRE(capture.Append(BridgeCapture::Direction::SENT, empty.data(), 0, start + milliseconds(3)));
+    REQUIRE(capture.GetRecordedCount() == 2);
+    capture.Close();
+
+    size_t expected_size = BridgeCapture::kHeaderSize + 2 * BridgeCapture::kRecordOverhead + position.size();
+    REQUIRE(std::filesystem::file_size(path) == expected_size);
+
+    std::vector<char> data;
+    std::vector<BridgeCapture::Record> records;
+    REQUIRE(BridgeCapture::Read(path, data, records));
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[0].direction == BridgeCapture::Direction::RECEIVED);
+    REQUIRE(records[0].payload == position);
+    REQUIRE(records[1].direction == BridgeCapture::Direction::SENT);
+    REQUIRE(records[1].payload.empty());
+    REQUIRE(records[1].timestamp - records[0].timestamp == milliseconds(2));
+    // frames keep their wire length
+    REQUIRE(data[BridgeCapture::kHeaderSize + 8] == static_cast<char>(position.size() + 4));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Frames beyond the capture size are dropped", "[BridgeCapture]") {
+    auto path = CapturePath("slimevr_test_capture_full.bin");
+    BridgeCapture capture;
+    std::string payload(100, 'p');
+    size_t record_size = BridgeCapture::kRecordOverhead + payload.size();
+    REQUIRE(capture.Open(path, BridgeCapture::kHeaderSize + 3 * record_size + 50));
+
+    for (int i = 0; i < 5; i++) {
+        capture.Append(BridgeCapture::Direction::RECEIVED, payload.data(), static_cast<uint32_t>(payload.size()), steady_clock::now());
+    }
+    REQUIRE(capture.GetRecordedCount() == 3);
+    REQUIRE(capture.GetDroppedCount() == 2);
+    capture.Close();
+
+    std::vector<char> data;
+    std::vector<BridgeCapture::Record> records;
+    REQUIRE(BridgeCapture::Read(path, data, records));
+    REQUIRE(records.size() == 3);
+    REQUIRE(std::filesystem::file_size(path) == BridgeCapture::kHeaderSize + 3 * record_size);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Frames are captured from several threads", "[BridgeCapture]") {
+    auto path = CapturePath("slimevr_test_capture_threads.bin");
+    BridgeCapture capture;
+    REQUIRE(capture.Open(path, 16 << 20));
+
+    const int threads = 4;
+    const int frames = 10000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+        writers.emplace_back([&, t]() {
+            for (int i = 0; i < frames; i++) {
+                std::string payload = std::to_string(t) + ":" + std::to_string(i);
+                capture.Append(t ? BridgeCapture::Direction::SENT : BridgeCapture::Direction::RECEIVED, payload.data(), static_cast<uint32_t>(payload.size()), steady_clock::now());
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    capture.Close();
+
+    std::vector<char> data;
+    std::vector<BridgeCapture::Record> records;
+    REQUIRE(BridgeCapture::Read(path, data, records));
+    REQUIRE(records.size() == threads * frames);
+    // frames of one thread keep their order
+    std::vector<int> next(threads, 0);
+    for (const auto& record : records) {
+        int t = record.payload[0] - '0';
+        REQUIRE(record.payload == std::to_string(t) + ":" + std::to_string(next[t]));
+        REQUIRE((record.direction == BridgeCapture::Direction::RECEIVED) == (t == 0));
+        next[t]++;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Closing while other threads append", "[BridgeCapture]") {
+    auto path = CapturePath("slimevr_test_capture_close.bin");
+    std::string payload(100, 'p');
+    for (int round = 0; round < 20; round++) {
+        BridgeCapture capture;
+        REQUIRE(capture.Open(path, 1 << 20));
+        std::atomic<uint64_t> appended = 0;
+        std::atomic<uint64_t> appended_after_close = 0;
+        std::atomic<bool> closed = false;
+        std::vector<std::thread> writers;
+        for (int t = 0; t < 4; t++) {
+            writers.emplace_back([&]() {
+                while (!closed) {
+                    if (capture.Append(BridgeCapture::Direction::RECEIVED, payload.data(), static_cast<uint32_t>(payload.size()), steady_clock::now()))
+                        appended++;
+                }
+                // ignored once closed
+                if (capture.Append(BridgeCapture::Direction::RECEIVED, payload.data(), static_cast<uint32_t>(payload.size()), steady_clock::now()))
+                    appended_after_close++;
+            });
+        }
+        while (appended < 100) {
+            std::this_thread::yield();
+        }
+        capture.Close();
+        closed = true;
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        REQUIRE_FALSE(capture.IsOpen());
+        REQUIRE(appended_after_close == 0);
+
+        // every frame that was appended made it into the file, complete
+        std::vector<char> data;
+        std::vector<BridgeCapture::Record> records;
+        REQUIRE(BridgeCapture::Read(path, data, records));
+        REQUIRE(records.size() == appended);
+        REQUIRE(std::filesystem::file_size(path) == BridgeCapture::kHeaderSize + appended * (BridgeCapture::kRecordOverhead + payload.size()));
+        for (const auto& record : records) {
+            REQUIRE(record.payload == payload);
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Files that aren't captures are rejected", "[BridgeCapture]") {
+    auto path = CapturePath("slimevr_test_capture_invalid.bin");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not a capture file at all";
+    }
+    std::vector<char> data;
+    std::vector<BridgeCapture::Record> records;
+    REQUIRE_FALSE(BridgeCapture::Read(path, data, records));
+    REQUIRE_FALSE(BridgeCapture::Read(CapturePath("slimevr_test_capture_missing.bin"), data, records));
+    std::filesystem::remove(path);
+}
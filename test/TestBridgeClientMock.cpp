@@ -77,6 +77,8 @@ TEST_CASE("IO with a mock server", "[Bridge]") {
                 }
             } else if (message.has_version()) {
                 TestLogVersion(logger, message);
+            } else if (message.has_ping_pong()) {
+                server_mock->SendBridgeMessage(message);
             } else {
                 invalid_messages++;
             }
@@ -0,0 +1,179 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <format>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BridgeLoadGenerator.hpp"
+#include "common/DriverHarness.hpp"
+
+using namespace std::chrono;
+
+namespace {
+
+/**
+ * Runs the generator against a driver on a fake SteamVR, with its trackers added and activated beforehand.
+ *
+ * @param impairment Applied to what the server writes to the driver.
+ */
+BridgeLoadGenerator::Report RunLoad(BridgeLoadGenerator::Config config, const BridgeServerMock::Impairment& impairment = {}) {
+    // outlives the harness, the driver's threads call it until they are stopped
+    std::optional<BridgeLoadGenerator> generator;
+    DriverHarness harness([](const messages::ProtobufMessage&) { }, impairment);
+    generator.emplace(*harness.server, *harness.driver, config);
+    harness.context.SetPoseObserver([&](vr::TrackedDeviceIndex_t, const vr::DriverPose_t& pose) { generator->OnPoseSubmitted(pose); });
+    harness.Start();
+    harness.StartFrames();
+
+    REQUIRE(WaitFor([&]() { return harness.server->IsConnected(); }));
+    generator->AddTrackers();
+    REQUIRE(WaitFor([&]() { return harness.context.CountActivatedDevices() == static_cast<size_t>(config.trackers); }));
+
+    return generator->Run();
+}
+
+} // namespace
+
+TEST_CASE("Steady load reaches SteamVR", "[BridgeLoad]") {
+    BridgeLoadGenerator::Config config;
+    config.trackers = 8;
+    config.rate_hz = 200.0;
+    config.jitter = 0.3;
+    config.duration = 500ms;
+    config.churn_interval = 50ms;
+    config.churn_trackers = 2;
+    auto report = RunLoad(config);
+
+    // rates, drops and resets depend on the machine keeping up, the hidden benchmarks report them
+    REQUIRE(report.positions_sent > 0);
+    REQUIRE(report.churn_messages > 0);
+    REQUIRE(report.positions_submitted > 0);
+    REQUIRE(report.driver_parse_failures == 0);
+    REQUIRE(report.latency.count >= report.positions_submitted);
+}
+
+TEST_CASE("Driver recovers from dropped connections", "[BridgeLoad]") {
+    BridgeLoadGenerator::Config config;
+    config.trackers = 4;
+    config.rate_hz = 100.0;
+    // 200ms after positions flow again, the driver reconnects after a second each time
+    config.reconnect_interval = 200ms;
+    config.reconnect_storm = 1;
+    // leaves a slow machine time to recover
+    config.duration = 3s;
+    auto report = RunLoad(config);
+
+    REQUIRE(report.drops_requested >= 1);
+    REQUIRE(report.driver_reconnects >= 1);
+    REQUIRE(report.driver_parse_failures == 0);
+    REQUIRE(report.positions_skipped > 0);
+    // positions flow again after the reconnect, which can't happen before the reconnect delay
+    REQUIRE(report.max_recovery > 900ms);
+}
+
+TEST_CASE("Load scaling", "[BridgeLoad][.benchmark]") {
+    auto logger = std::static_pointer_cast<Logger>(std::make_shared<ConsoleLogger>(""));
+    for (int trackers : { 1, 10, 30, 60 }) {
+        for (double rate_hz : { 100.0, 500.0, 1000.0 }) {
+            BridgeLoadGenerator::Config config;
+            config.trackers = trackers;
+            config.rate_hz = rate_hz;
+            config.jitter = 0.2;
+            config.duration = 2s;
+            auto report = RunLoad(config);
+            logger->Log("{} trackers at {}Hz: {}", trackers, rate_hz, report.ToJson());
+        }
+    }
+}
+
+TEST_CASE("Load with churn and reconnect storms", "[BridgeLoad][.benchmark]") {
+    auto logger = std::static_pointer_cast<Logger>(std::make_shared<ConsoleLogger>(""));
+    BridgeLoadGenerator::Config config;
+    config.trackers = 30;
+    config.rate_hz = 500.0;
+    config.jitter = 0.5;
+    config.duration = 10s;
+    config.churn_interval = 100ms;
+    config.churn_trackers = 10;
+    config.reconnect_interval = 4s;
+    config.reconnect_storm = 3;
+    auto report = RunLoad(config);
+    logger->Log("churn and reconnect storms: {}", report.ToJson());
+}
+
+TEST_CASE("Frames split over many reads", "[BridgeLoad][BridgeImpairment]") {
+    BridgeLoadGenerator::Config config;
+    config.trackers = 2;
+    config.rate_hz = 20.0;
+    config.duration = 500ms;
+    BridgeServerMock::Impairment impairment;
+    // the 4 byte size header arrives on its own and the last bytes of a frame come after the rest
+    impairment.split_bytes = 3;
+    impairment.split_gap = 1ms;
+    auto report = RunLoad(config, impairment);
+
+    // the split frames are put back together, how many make it in time depends on the machine
+    REQUIRE(report.positions_submitted > 0);
+    REQUIRE(report.driver_parse_failures == 0);
+}
+
+TEST_CASE("Frames coalesced into one read", "[BridgeLoad][BridgeImpairment]") {
+    BridgeLoadGenerator::Config config;
+    config.trackers = 10;
+    config.rate_hz = 200.0;
+    config.duration = 500ms;
+    BridgeServerMock::Impairment impairment;
+    impairment.coalesce = 20ms;
+    auto report = RunLoad(config, impairment);
+
+    REQUIRE(report.positions_submitted > 0);
+    REQUIRE(report.driver_parse_failures == 0);
+    // positions wait for the end of the interval
+    REQUIRE(report.latency.p50_us > 1000);
+}
+
+TEST_CASE("Driver recovers from a connection cut mid-frame", "[BridgeLoad][BridgeImpairment]") {
+    BridgeLoadGenerator::Config config;
+    config.trackers = 4;
+    config.rate_hz = 100.0;
+    // leaves a slow machine time to recover
+    config.duration = 3s;
+    BridgeServerMock::Impairment impairment;
+    // an odd count ends in the middle of a position
+    impairment.drop_after_bytes = 1017;
+    auto report = RunLoad(config, impairment);
+
+    REQUIRE(report.disconnects >= 1);
+    REQUIRE(report.driver_reconnects >= 1);
+    REQUIRE(report.driver_parse_failures == 0);
+    REQUIRE(report.max_recovery > 900ms);
+}
+
+TEST_CASE("Load over impaired connections", "[BridgeLoad][BridgeImpairment][.benchmark]") {
+    auto logger = std::static_pointer_cast<Logger>(std::make_shared<ConsoleLogger>(""));
+    BridgeLoadGenerator::Config config;
+    config.trackers = 30;
+    config.rate_hz = 500.0;
+    config.jitter = 0.2;
+    config.duration = 3s;
+
+    std::vector<std::pair<std::string, BridgeServerMock::Impairment>> impairments;
+    impairments.push_back({ "none", {} });
+    impairments.push_back({ "split into 1 byte writes", { .split_bytes = 1 } });
+    impairments.push_back({ "split into 16 byte writes, 1ms apart", { .split_bytes = 16, .split_gap = 1ms } });
+    for (auto interval : { 5ms, 20ms, 50ms })
+        impairments.push_back({ std::format("coalesced every {}ms", interval.count()), { .coalesce = interval } });
+    impairments.push_back({ "delayed by 10ms", { .delay = 10ms } });
+    impairments.push_back({ "stalled for 50ms every 500ms", { .stall_every = 500ms, .stall_for = 50ms } });
+    impairments.push_back({ "cut mid-frame after 64KB", { .drop_after_bytes = 64 * 1024 + 3 } });
+
+    for (const auto& [name, impairment] : impairments) {
+        auto report = RunLoad(config, impairment);
+        logger->Log("{}: {}", name, report.ToJson());
+    }
+}
@@ -0,0 +1,265 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BridgeReplay.hpp"
+#include "Logger.hpp"
+#include "TrackerRole.hpp"
+#include "common/DriverHarness.hpp"
+
+using namespace std::chrono;
+
+namespace {
+
+std::string TrackerSerial(int id) {
+    return "human://" + std::to_string(id);
+}
+
+/**
+ * Writes a capture of trackers sending positions every interval, with a ping from the driver between rounds.
+ */
+std::filesystem::path WriteCapture(const char* name, int trackers, int rounds, steady_clock::duration interval) {
+    auto path = std::filesystem::temp_directory_path() / name;
+    BridgeCapture capture;
+    REQUIRE(capture.Open(path, 16 << 20));
+    auto start = steady_clock::now();
+    messages::ProtobufMessage message;
+    auto append = [&](BridgeCapture::Direction direction, steady_clock::time_point at) {
+        std::string payload = message.SerializeAsString();
+        REQUIRE(capture.Append(direction, payload.data(), static_cast<uint32_t>(payload.size()), at));
+    };
+
+    for (int id = 0; id < trackers; id++) {
+        auto* tracker_added = message.mutable_tracker_added();
+        tracker_added->set_tracker_id(id);
+        tracker_added->set_tracker_role(TrackerRole::WAIST);
+        tracker_added->set_tracker_serial(TrackerSerial(id));
+        append(BridgeCapture::Direction::RECEIVED, start);
+    }
+    for (int round = 0; round < rounds; round++) {
+        auto at = start + round * interval;
+        for (int id = 0; id < trackers; id++) {
+            auto* position = message.mutable_position();
+            position->set_tracker_id(id);
+            position->set_x(static_cast<float>(round));
+            position->set_qw(1.0f);
+            append(BridgeCapture::Direction::RECEIVED, at);
+        }
+        message.mutable_ping_pong()->set_sent_at_us(round);
+        append(BridgeCapture::Direction::SENT, at);
+    }
+    capture.Close();
+    return path;
+}
+
+/**
+ * Replays what the driver received into its message handler, on this thread. SteamVR activates the trackers it adds
+ * right away, before their first position.
+ */
+void ReplayIntoDriver(const BridgeReplay& replay, FakeDriverContext& context, SlimeVRDriver::VRDriver& driver, BridgeReplay::Result& result) {
+    replay.Run(
+        [&](const messages::ProtobufMessage& message) {
+            driver.OnBridgeMessage(message);
+            if (message.has_tracker_added())
+                context.ActivateAddedDevices();
+        },
+        result,
+        BridgeReplay::kMaxSpeed);
+}
+
+/**
+ * Replays what the driver received through the server to the connected driver. Before the first message after trackers
+ * were added, waits for SteamVR to activate them, so none of their positions are dropped.
+ */
+void ReplayThroughServer(const BridgeReplay& replay, DriverHarness& harness, BridgeReplay::Result& result, double speed) {
+    std::vector<std::string> added;
+    replay.Run(
+        [&](const messages::ProtobufMessage& message) {
+            if (message.has_tracker_added()) {
+                added.push_back(message.tracker_added().tracker_serial());
+            } else if (!added.empty()) {
+                REQUIRE(WaitFor([&]() {
+                    for (const auto& serial : added) {
+                        if (!harness.context.IsActivated(harness.context.FindDriverDevice(serial)))
+                            return false;
+                    }
+                    return true;
+                }));
+                added.clear();
+            }
+            harness.server->SendBridgeMessage(message);
+        },
+        result,
+        speed);
+}
+
+} // namespace
+
+TEST_CASE("Replaying as fast as possible", "[BridgeReplay]") {
+    auto path = WriteCapture("slimevr_test_replay.bin", 5, 100, milliseconds(2));
+    BridgeReplay replay;
+    REQUIRE(replay.Load(path));
+    REQUIRE(replay.GetRecords().size() == 5 + 100 * 6);
+
+    int added = 0;
+    std::vector<int> last_round(5, -1);
+    BridgeReplay::Result result;
+    replay.Run(
+        [&](const messages::ProtobufMessage& message) {
+            if (message.has_tracker_added()) {
+                added++;
+            } else {
+                REQUIRE(message.has_position());
+                // positions of every tracker arrive in recorded order
+                int round = static_cast<int>(message.position().x());
+                REQUIRE(round == last_round[message.position().tracker_id()] + 1);
+                last_round[message.position().tracker_id()] = round;
+            }
+        },
+        result,
+        BridgeReplay::kMaxSpeed);
+
+    REQUIRE(added == 5);
+    REQUIRE(last_round == std::vector<int>(5, 99));
+    REQUIRE(result.messages == 505);
+    REQUIRE(result.parse_failures == 0);
+    REQUIRE(result.handle_latency.Summarize().count == 505);
+    REQUIRE(result.lateness.Summarize().count == 0);
+    REQUIRE(result.ToJson().starts_with(R"({"messages":505,)"));
+
+    BridgeReplay::Result pings;
+    replay.Run([&](const messages::ProtobufMessage& message) { REQUIRE(message.has_ping_pong()); }, pings, BridgeReplay::kMaxSpeed, BridgeCapture::Direction::SENT);
+    REQUIRE(pings.messages == 100);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Replaying at a scaled speed keeps the recorded timing", "[BridgeReplay]") {
+    auto path = WriteCapture("slimevr_test_replay_timed.bin", 2, 21, milliseconds(10));
+    BridgeReplay replay;
+    REQUIRE(replay.Load(path));
+
+    BridgeReplay::Result result;
+    replay.Run([](const messages::ProtobufMessage&) { }, result, 2.0);
+    REQUIRE(result.messages == 2 + 21 * 2);
+    // 200ms recorded at double speed, how much later it finishes depends on the machine
+    REQUIRE(result.elapsed >= milliseconds(100));
+    REQUIRE(result.lateness.Summarize().count == result.messages);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Replaying a capture into the driver", "[BridgeReplay]") {
+    auto path = WriteCapture("slimevr_test_replay_driver.bin", 5, 100, milliseconds(2));
+    BridgeReplay replay;
+    REQUIRE(replay.Load(path));
+
+    // no server, the replay is the only caller of the driver's message handler
+    FakeDriverContext context;
+    context.AddHeadset();
+    auto driver = std::make_shared<SlimeVRDriver::VRDriver>();
+    SlimeVRDriver::SetDriver(driver);
+    REQUIRE(driver->Init(&context) == vr::VRInitError_None);
+    DriverGuard guard(context, *driver);
+
+    BridgeReplay::Result result;
+    ReplayIntoDriver(replay, context, *driver, result);
+    REQUIRE(result.messages == 505);
+    REQUIRE(result.parse_failures == 0);
+
+    REQUIRE(driver->GetDevices().size() == 5);
+    for (int id = 0; id < 5; id++) {
+        auto tracker = context.FindDriverDevice(TrackerSerial(id));
+        REQUIRE(context.IsActivated(tracker));
+        // every recorded position is submitted, the last one is of the last round
+        auto submitted = context.GetSubmittedPoses(tracker);
+        REQUIRE(submitted.count == 100);
+        REQUIRE(submitted.last.vecPosition[0] == 99.0);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Replaying a capture through the server", "[BridgeReplay]") {
+    // small enough to fit the server's send buffer if it's all written at once
+    auto path = WriteCapture("slimevr_test_replay_server.bin", 3, 50, milliseconds(2));
+    BridgeReplay replay;
+    REQUIRE(replay.Load(path));
+
+    DriverHarness harness;
+    harness.Start();
+    harness.StartFrames();
+    REQUIRE(WaitFor([&]() { return harness.server->IsConnected(); }));
+
+    BridgeReplay::Result result;
+    ReplayThroughServer(replay, harness, result, 1.0);
+    REQUIRE(result.messages == 153);
+    REQUIRE(result.parse_failures == 0);
+
+    for (int id = 0; id < 3; id++) {
+        auto tracker = harness.context.FindDriverDevice(TrackerSerial(id));
+        REQUIRE(WaitFor([&]() { return harness.context.GetSubmittedPoses(tracker).last.vecPosition[0] == 49.0; }));
+        REQUIRE(harness.context.GetSubmittedPoses(tracker).count == 50);
+    }
+    REQUIRE(harness.driver->GetDevices().size() == 3);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Replay throughput", "[BridgeReplay][.benchmark]") {
+    auto logger = std::static_pointer_cast<Logger>(std::make_shared<ConsoleLogger>(""));
+    // a recorded capture, see the bridgeCaptureFile setting
+    const char* capture = std::getenv("SLIMEVR_REPLAY_CAPTURE");
+    auto path = capture ? std::filesystem::path(capture) : WriteCapture("slimevr_bench_replay.bin", 20, 2500, milliseconds(4));
+    BridgeReplay replay;
+    REQUIRE(replay.Load(path));
+
+    uint64_t positions = 0;
+    BridgeReplay::Result parsed;
+    replay.Run(
+        [&](const messages::ProtobufMessage& message) {
+            if (message.has_position())
+                positions++;
+        },
+        parsed,
+        BridgeReplay::kMaxSpeed);
+    logger->Log("{} positions from {}, parsed: {}", positions, path.string(), parsed.ToJson());
+
+    auto count_submitted = [](FakeDriverContext& context, SlimeVRDriver::VRDriver& driver) {
+        uint64_t submitted = 0;
+        for (auto& device : driver.GetDevices())
+            submitted += context.GetSubmittedPoses(device->GetDeviceIndex()).count;
+        return submitted;
+    };
+
+    {
+        FakeDriverContext context;
+        context.AddHeadset();
+        auto driver = std::make_shared<SlimeVRDriver::VRDriver>();
+        SlimeVRDriver::SetDriver(driver);
+        REQUIRE(driver->Init(&context) == vr::VRInitError_None);
+        DriverGuard guard(context, *driver);
+
+        BridgeReplay::Result handled;
+        ReplayIntoDriver(replay, context, *driver, handled);
+        logger->Log("into OnBridgeMessage, {} poses submitted: {}", count_submitted(context, *driver), handled.ToJson());
+    }
+
+    {
+        DriverHarness harness;
+        harness.Start();
+        harness.StartFrames();
+        REQUIRE(WaitFor([&]() { return harness.server->IsConnected(); }));
+
+        // as recorded, as fast as possible would overflow the server's send buffer and reset the connection
+        BridgeReplay::Result sent;
+        ReplayThroughServer(replay, harness, sent, 1.0);
+        WaitFor([&]() { return count_submitted(harness.context, *harness.driver) >= positions; }, 1s);
+        logger->Log("through the server, {} poses submitted: {}", count_submitted(harness.context, *harness.driver), sent.ToJson());
+        logger->Log("driver bridge: {}", harness.driver->DebugRequest("bridge"));
+    }
+
+    if (!capture)
+        std::filesystem::remove(path);
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+
+#include "bridge/BridgeStats.hpp"
+
+namespace {
+
+messages::ProtobufMessage MakePosition(int32_t tracker_id) {
+    messages::ProtobufMessage message;
+    message.mutable_position()->set_tracker_id(tracker_id);
+    return message;
+}
+
+} // namespace
+
+TEST_CASE("Messages are counted by type and tracker", "[BridgeStats]") {
+    BridgeStats stats;
+    auto before = stats.TakeSnapshot();
+    before.taken_at -= std::chrono::seconds(2);
+
+    for (int i = 0; i < 10; i++) {
+        stats.CountIn(MakePosition(3), 40);
+    }
+    stats.CountIn(MakePosition(4), 40);
+    stats.CountIn(MakePosition(1000), 40);
+    stats.CountIn(MakePosition(-1), 40);
+    messages::ProtobufMessage battery;
+    battery.mutable_battery()->set_tracker_id(3);
+    stats.CountIn(battery, 20);
+    messages::ProtobufMessage version;
+    version.mutable_version()->set_protocol_version(3);
+    stats.CountOut(version, 8);
+    stats.CountParseFailure();
+    stats.CountReset();
+    stats.UpdateSendHighWater(100);
+    stats.UpdateSendHighWater(50);
+
+    auto after = stats.TakeSnapshot();
+    REQUIRE(after.in.messages[messages::ProtobufMessage::kPosition] == 13);
+    REQUIRE(after.in.bytes[messages::ProtobufMessage::kPosition] == 13 * 40);
+    REQUIRE(after.in.messages[messages::ProtobufMessage::kBattery] == 1);
+    REQUIRE(after.out.messages[messages::ProtobufMessage::kVersion] == 1);
+    REQUIRE(after.out.bytes[messages::ProtobufMessage::kVersion] == 8);
+    REQUIRE(after.tracker_positions[3] == 10);
+    REQUIRE(after.tracker_positions[4] == 1);
+    // ids out of range share the last counter
+    REQUIRE(after.tracker_positions[BridgeStats::kMaxTrackerId + 1] == 2);
+    REQUIRE(after.send_high_water == 100);
+
+    std::string json = BridgeStats::ToJson(after, before);
+    REQUIRE(json.find(R"("position":{"messages":13,"bytes":520})") != std::string::npos);
+    REQUIRE(json.find(R"("version":{"messages":1,"bytes":8})") != std::string::npos);
+    REQUIRE(json.find(R"("parse_failures":1,)") != std::string::npos);
+    REQUIRE(json.find(R"("send_high_water":100,)") != std::string::npos);
+    // about 10 positions over 2 seconds
+    REQUIRE(json.find(R"({"id":3,"positions":10,"rate_hz":5.0})") != std::string::npos);
+    REQUIRE(json.find(R"({"id":"other","positions":2,)") != std::string::npos);
+
+    std::string line = BridgeStats::FormatDelta(after, before);
+    REQUIRE(line.find("1 parse failures") != std::string::npos);
+    REQUIRE(line.find("tracker 3 5.0 Hz") != std::string::npos);
+    REQUIRE(line.find("reconnects") == std::string::npos);
+}
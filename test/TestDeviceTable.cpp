@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <format>
+#include <thread>
+
+#include "DeviceTable.hpp"
+#include "TrackerDevice.hpp"
+
+using SlimeVRDriver::DeviceTable;
+using SlimeVRDriver::IVRDevice;
+using SlimeVRDriver::TrackerDevice;
+
+static std::shared_ptr<IVRDevice> MakeDevice(int id) {
+    return std::make_shared<TrackerDevice>(std::format("human://{}", id), id, TrackerRole::WAIST);
+}
+
+TEST_CASE("Add/FindById", "[DeviceTable]") {
+    DeviceTable table;
+    table.Quiesce(DeviceTable::Reader::FRAME);
+    REQUIRE(table.FindById(0) == nullptr);
+    REQUIRE(table.FindById(-1) == nullptr);
+
+    auto device = MakeDevice(3);
+    table.Add(device);
+    REQUIRE(table.FindById(3) == device.get());
+    REQUIRE(table.FindById(2) == nullptr);
+    REQUIRE(table.FindById(4) == nullptr);
+    REQUIRE(table.Get().devices.size() == 1);
+
+    // ids are sparse, large ones don't grow the index
+    auto far_device = MakeDevice(1 << 30);
+    table.Add(far_device);
+    REQUIRE(table.FindById(1 << 30) == far_device.get());
+    REQUIRE(table.FindById(3) == device.get());
+    REQUIRE(table.Get().by_id.size() == 2);
+}
+
+TEST_CASE("MapId", "[DeviceTable]") {
+    DeviceTable table;
+    table.Quiesce(DeviceTable::Reader::FRAME);
+    auto device = MakeDevice(1);
+    table.Add(device);
+    table.MapId(7, device.get());
+    REQUIRE(table.FindById(1) == device.get());
+    REQUIRE(table.FindById(7) == device.get());
+    REQUIRE(table.Get().devices.size() == 1);
+
+    auto other = MakeDevice(2);
+    table.Add(other);
+    table.MapId(7, other.get());
+    REQUIRE(table.FindById(7) == other.get());
+    REQUIRE(table.Get().by_id.size() == 3);
+}
+
+TEST_CASE("Snapshots survive later writes until the reader quiesces", "[DeviceTable]") {
+    DeviceTable table;
+    table.Quiesce(DeviceTable::Reader::FRAME);
+    table.Quiesce(DeviceTable::Reader::BRIDGE);
+    table.Add(MakeDevice(0));
+    const DeviceTable::Snapshot& old_snapshot = table.Get();
+
+    for (int id = 1; id < 64; id++) {
+        table.Add(MakeDevice(id));
+    }
+
+    REQUIRE(old_snapshot.devices.size() == 1);
+    REQUIRE(old_snapshot.FindById(0) != nullptr);
+    REQUIRE(old_snapshot.FindById(1) == nullptr);
+    REQUIRE(table.Get().devices.size() == 64);
+    REQUIRE(table.CountRetired() == 64);
+
+    // one reader passing a quiescent point isn't enough
+    table.Quiesce(DeviceTable::Reader::FRAME);
+    table.Add(MakeDevice(64));
+    REQUIRE(table.CountRetired() == 65);
+
+    table.Quiesce(DeviceTable::Reader::BRIDGE);
+    table.Add(MakeDevice(65));
+    // the frame reader may still use the snapshots superseded after its quiescent point
+    REQUIRE(table.CountRetired() == 2);
+
+    table.GoOffline(DeviceTable::Reader::FRAME);
+    table.GoOffline(DeviceTable::Reader::BRIDGE);
+    table.MapId(100, nullptr);
+    REQUIRE(table.CountRetired() == 0);
+    REQUIRE(table.CopyDevices().size() == 66);
+}
+
+TEST_CASE("Concurrent readers and writer", "[DeviceTable]") {
+    DeviceTable table;
+    const int n = 256;
+    std::atomic<bool> done = false;
+    int errors = 0;
+
+    std::thread reader{ [&]() {
+        size_t last_seen = 0;
+        while (!done) {
+            table.Quiesce(DeviceTable::Reader::FRAME);
+            const auto& snapshot = table.Get();
+            // devices are only ever appended, so a later snapshot can't have fewer
+            if (snapshot.devices.size() < last_seen)
+                errors++;
+            last_seen = snapshot.devices.size();
+            for (const auto& device : snapshot.devices) {
+                if (snapshot.FindById(device->GetDeviceId()) != device.get())
+                    errors++;
+            }
+        }
+        table.GoOffline(DeviceTable::Reader::FRAME);
+    } };
+
+    for (int id = 0; id < n; id++) {
+        table.Add(MakeDevice(id));
+    }
+    done = true;
+    reader.join();
+
+    REQUIRE(errors == 0);
+    REQUIRE(table.CopyDevices().size() == n);
+    table.Add(MakeDevice(n));
+    REQUIRE(table.CountRetired() == 0);
+}
@@ -0,0 +1,260 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+#include "TrackerRole.hpp"
+#include "common/DriverHarness.hpp"
+
+using namespace std::chrono;
+using SlimeVRDriver::LatencyHistogram;
+
+namespace {
+
+constexpr vr::HmdQuaternion_t kIdentity{ 1, 0, 0, 0 };
+
+/**
+ * What the mock server received from the driver.
+ */
+struct ServerView {
+    std::mutex mutex;
+    bool version = false;
+    std::map<int32_t, messages::TrackerAdded> added;
+    std::map<int32_t, messages::Position> positions;
+    uint64_t position_count = 0;
+    std::vector<messages::HapticFeedback> haptics;
+};
+
+/**
+ * Returns a server message handler that records what the driver sent into `view`.
+ */
+std::function<void(const messages::ProtobufMessage&)> RecordInto(ServerView& view, std::function<void(const messages::Position&)> on_position = nullptr) {
+    return [&view, on_position](const messages::ProtobufMessage& message) {
+        if (message.has_position() && on_position)
+            on_position(message.position());
+        std::lock_guard<std::mutex> lock(view.mutex);
+        if (message.has_version()) {
+            view.version = true;
+        } else if (message.has_tracker_added()) {
+            view.added[message.tracker_added().tracker_id()] = message.tracker_added();
+        } else if (message.has_position()) {
+            view.positions[message.position().tracker_id()] = message.position();
+            view.position_count++;
+        } else if (message.has_haptic_feedback()) {
+            view.haptics.push_back(message.haptic_feedback());
+        }
+    };
+}
+
+} // namespace
+
+TEST_CASE("Driver runs against a fake SteamVR and a mock server", "[Driver]") {
+    ServerView view;
+    DriverHarness harness(RecordInto(view));
+    harness.context.SetUniverse(7, { 1.f, 0.f, 2.f }, 0.f);
+    harness.Start();
+    harness.StartFrames();
+    // driver log messages are written by a thread
+    REQUIRE(WaitFor([&]() { return harness.context.HasLogged("SlimeVR Driver Loaded Successfully"); }));
+
+    // the headset is sent to the server, in the universe's space
+    REQUIRE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(view.mutex);
+        return view.version && view.added.size() == 3 && view.positions.size() == 3;
+    }));
+    {
+        std::lock_guard<std::mutex> lock(view.mutex);
+        REQUIRE(view.added[0].tracker_role() == TrackerRole::HMD);
+        REQUIRE(view.added[0].tracker_serial() == "HMD");
+        REQUIRE(view.added[1].tracker_role() == TrackerRole::LEFT_HAND);
+        REQUIRE(view.added[2].tracker_role() == TrackerRole::RIGHT_HAND);
+        REQUIRE(std::abs(view.positions[0].x() - 1.f) < 1e-5f);
+        REQUIRE(std::abs(view.positions[0].y() - 1.7f) < 1e-5f);
+        REQUIRE(std::abs(view.positions[0].z() - 2.f) < 1e-5f);
+    }
+
+    // trackers of the server are added to SteamVR and their poses submitted
+    SendTracker(*harness.server, 3, TrackerRole::WAIST, "human://WAIST");
+    vr::TrackedDeviceIndex_t waist = vr::k_unTrackedDeviceIndexInvalid;
+    REQUIRE(WaitFor([&]() {
+        waist = harness.context.FindDriverDevice("human://WAIST");
+        return waist != vr::k_unTrackedDeviceIndexInvalid && harness.driver->GetDevices().size() == 1;
+    }));
+    auto waist_container = harness.context.GetProperties().TrackedDeviceToPropertyContainer(waist);
+    REQUIRE(WaitFor([&]() { return harness.context.GetProperties().GetStringProperty(waist_container, vr::Prop_ModelNumber_String) == "SlimeVR Virtual Tracker"; }));
+    SendPosition(*harness.server, 3, 0.5f);
+    REQUIRE(WaitFor([&]() { return harness.context.GetSubmittedPoses(waist).last.vecPosition[0] == 0.5; }));
+    auto submitted = harness.context.GetSubmittedPoses(waist);
+    REQUIRE(submitted.last.poseIsValid);
+    REQUIRE(submitted.last.vecWorldFromDriverTranslation[0] == -1.0);
+    REQUIRE(submitted.last.vecWorldFromDriverTranslation[2] == -2.0);
+
+    // our own devices aren't sent back to the server
+    std::this_thread::sleep_for(20ms);
+    std::lock_guard<std::mutex> lock(view.mutex);
+    REQUIRE_FALSE(view.added.count(waist));
+}
+
+TEST_CASE("Haptic vibrations are forwarded to servers that know HapticFeedback", "[Driver]") {
+    ServerView view;
+    DriverHarness harness(RecordInto(view));
+    harness.Start();
+    harness.StartFrames();
+
+    REQUIRE(WaitFor([&]() { return harness.server->IsConnected(); }));
+    SendTracker(*harness.server, 3, TrackerRole::WAIST, "human://WAIST");
+    vr::TrackedDeviceIndex_t waist = vr::k_unTrackedDeviceIndexInvalid;
+    vr::VRInputComponentHandle_t haptic = vr::k_ulInvalidInputComponentHandle;
+    REQUIRE(WaitFor([&]() {
+        waist = harness.context.FindDriverDevice("human://WAIST");
+        haptic = harness.context.FindInputComponent(waist, "/output/haptic");
+        return haptic != vr::k_ulInvalidInputComponentHandle;
+    }));
+
+    vr::VREvent_Data_t data{};
+    data.hapticVibration.containerHandle = harness.context.GetProperties().TrackedDeviceToPropertyContainer(waist);
+    data.hapticVibration.componentHandle = haptic;
+    data.hapticVibration.fDurationSeconds = 0.25f;
+    data.hapticVibration.fFrequency = 160.f;
+    data.hapticVibration.fAmplitude = 0.5f;
+    auto send_version = [&](int32_t protocol_version) {
+        messages::ProtobufMessage message;
+        message.mutable_version()->set_protocol_version(protocol_version);
+        harness.server->SendBridgeMessage(message);
+        REQUIRE(WaitFor([&]() { return harness.driver->GetServerProtocolVersion() == protocol_version; }));
+    };
+
+    // a server older than protocol version 3 doesn't know the message, nothing is sent
+    send_version(2);
+    harness.context.PushEvent(vr::VREvent_Input_HapticVibration, waist, data);
+    std::this_thread::sleep_for(100ms);
+    {
+        std::lock_guard<std::mutex> lock(view.mutex);
+        REQUIRE(view.haptics.empty());
+    }
+
+    send_version(3);
+    harness.context.PushEvent(vr::VREvent_Input_HapticVibration, waist, data);
+    REQUIRE(WaitFor([&]() {
+        std::lock_guard<std::mutex> lock(view.mutex);
+        return !view.haptics.empty();
+    }));
+    std::this_thread::sleep_for(20ms);
+    std::lock_guard<std::mutex> lock(view.mutex);
+    REQUIRE(view.haptics.size() == 1);
+    REQUIRE(view.haptics[0].tracker_id() == 3);
+    REQUIRE(view.haptics[0].duration_seconds() == 0.25f);
+    REQUIRE(view.haptics[0].frequency() == 160.f);
+    REQUIRE(view.haptics[0].amplitude() == 0.5f);
+}
+
+TEST_CASE("Suppressed bridge log messages are reported", "[Driver]") {
+    DriverHarness harness;
+    // longer than the second the bridge waits before reconnecting
+    harness.context.GetSettings().SetFloat("driver_slimevr", "logRateLimitSeconds", 2.f);
+    harness.Start();
+    harness.StartFrames();
+
+    // an oversized message makes the bridge log and reset the connection, the second one within the interval is
+    // suppressed
+    messages::ProtobufMessage oversized;
+    oversized.mutable_tracker_added()->set_tracker_name(std::string(VRBRIDGE_MAX_MESSAGE_SIZE * 2, 'x'));
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(WaitFor([&]() { return harness.server->IsConnected(); }));
+        harness.server->SendBridgeMessage(oversized);
+        REQUIRE(WaitFor([&]() { return !harness.server->IsConnected(); }));
+    }
+    REQUIRE(WaitFor([&]() { return harness.context.HasLogged("Bridge: message size overflow"); }));
+    REQUIRE(WaitFor([&]() { return harness.context.HasLogged("Bridge: suppressed 1 times"); }));
+}
+
+TEST_CASE("End-to-end throughput and latency", "[Driver][.benchmark]") {
+    auto logger = std::static_pointer_cast<Logger>(std::make_shared<ConsoleLogger>(""));
+    const int trackers = 10;
+    const int rate_hz = 1000;
+    const auto run_for = 3s;
+
+    // server to SteamVR, the x of each position is its sequence number
+    const size_t position_count = trackers * rate_hz * duration_cast<seconds>(run_for).count();
+    auto sent_at = std::make_unique<std::atomic<int64_t>[]>(position_count);
+    LatencyHistogram server_to_submit;
+    std::atomic<uint64_t> submitted = 0;
+
+    // SteamVR to server, the x of the HMD is the sequence number
+    std::atomic<int64_t> hmd_moved_at = 0;
+    std::atomic<int> hmd_sequence = 1;
+    LatencyHistogram hmd_to_server;
+    ServerView view;
+    DriverHarness harness(RecordInto(view, [&](const messages::Position& position) {
+        if (position.tracker_id() == 0 && static_cast<int>(position.x()) == hmd_sequence.load()) {
+            hmd_to_server.Record(steady_clock::duration(steady_clock::now().time_since_epoch().count() - hmd_moved_at.load()));
+            hmd_sequence++;
+        }
+    }));
+    harness.context.SetPoseObserver([&](vr::TrackedDeviceIndex_t, const vr::DriverPose_t& pose) {
+        auto now = steady_clock::now().time_since_epoch().count();
+        auto sequence = static_cast<size_t>(pose.vecPosition[0]);
+        if (sequence < position_count && pose.vecPosition[0] >= 1.0) {
+            server_to_submit.Record(steady_clock::duration(now - sent_at[sequence].load(std::memory_order_relaxed)));
+            submitted++;
+        }
+    });
+    harness.Start();
+    harness.StartFrames();
+    {
+        REQUIRE(WaitFor([&]() {
+            std::lock_guard<std::mutex> lock(view.mutex);
+            return view.version && view.added.size() == 3;
+        }));
+        for (int32_t id = 0; id < trackers; id++) {
+            SendTracker(*harness.server, 100 + id, TrackerRole::WAIST, "human://BENCH_" + std::to_string(id));
+        }
+        REQUIRE(WaitFor([&]() { return harness.context.FindDriverDevice("human://BENCH_" + std::to_string(trackers - 1)) != vr::k_unTrackedDeviceIndexInvalid; }));
+        std::this_thread::sleep_for(50ms);
+
+        std::thread hmd_thread([&]() {
+            auto end = steady_clock::now() + run_for;
+            int moved = -1;
+            while (steady_clock::now() < end) {
+                int sequence = hmd_sequence.load();
+                if (sequence != moved) {
+                    hmd_moved_at = steady_clock::now().time_since_epoch().count();
+                    harness.context.SetPose(0, { static_cast<float>(sequence), 1.7f, 0.f }, kIdentity);
+                    moved = sequence;
+                }
+                std::this_thread::sleep_for(1ms);
+            }
+        });
+
+        auto start = steady_clock::now();
+        auto period = duration_cast<steady_clock::duration>(duration<double>(1.0 / rate_hz));
+        for (size_t sequence = 1; sequence < position_count; sequence++) {
+            if (sequence % trackers == 0)
+                std::this_thread::sleep_until(start + period * (sequence / trackers));
+            sent_at[sequence].store(steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            SendPosition(*harness.server, 100 + static_cast<int32_t>(sequence % trackers), static_cast<float>(sequence));
+        }
+        auto sent_in = steady_clock::now() - start;
+        WaitFor([&]() { return submitted >= position_count - 1; }, 1s);
+        hmd_thread.join();
+
+        logger->Log(
+            "{} positions sent in {}ms, {} submitted ({:.0f}/s)",
+            position_count - 1,
+            duration_cast<milliseconds>(sent_in).count(),
+            submitted.load(),
+            submitted.load() / duration<double>(sent_in).count());
+        logger->Log("server to submit: {}", server_to_submit.ToJson());
+        logger->Log("HMD to server: {}", hmd_to_server.ToJson());
+        logger->Log("driver latency: {}", harness.driver->DebugRequest("latency"));
+        logger->Log("driver bridge: {}", harness.driver->DebugRequest("bridge"));
+    }
+}
@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+#include "EventIndex.hpp"
+
+using SlimeVRDriver::EventIndex;
+
+namespace {
+
+vr::VREvent_t MakeEvent(uint32_t type, vr::TrackedDeviceIndex_t index, float age = 0.f) {
+    vr::VREvent_t event{};
+    event.eventType = type;
+    event.trackedDeviceIndex = index;
+    event.eventAgeSeconds = age;
+    return event;
+}
+
+vr::VREvent_t MakeHapticEvent(vr::VRInputComponentHandle_t component, vr::TrackedDeviceIndex_t index = 0) {
+    vr::VREvent_t event = MakeEvent(vr::VREvent_Input_HapticVibration, index);
+    event.data.hapticVibration.componentHandle = component;
+    return event;
+}
+
+} // namespace
+
+TEST_CASE("Events are grouped by device and component", "[EventIndex]") {
+    std::vector<vr::VREvent_t> events = {
+        MakeEvent(vr::VREvent_PropertyChanged, 3, 0.f),
+        MakeHapticEvent(42, 7),
+        MakeEvent(vr::VREvent_TrackedDeviceActivated, 1),
+        MakeEvent(vr::VREvent_PropertyChanged, 3, 1.f),
+        MakeHapticEvent(43),
+        MakeEvent(vr::VREvent_PropertyChanged, 3, 2.f),
+    };
+    EventIndex index;
+    index.Build(events);
+
+    auto device_events = index.ForDevice(3);
+    REQUIRE(device_events.size() == 3);
+    // poll order is kept
+    for (size_t i = 0; i < device_events.size(); i++) {
+        REQUIRE(device_events[i].event->eventAgeSeconds == static_cast<float>(i));
+    }
+    REQUIRE(index.ForDevice(1).size() == 1);
+    REQUIRE(index.ForDevice(2).empty());
+
+    // haptic events are only found by component, whatever their device index
+    REQUIRE(index.ForDevice(7).empty());
+    REQUIRE(index.ForHapticComponent(42).size() == 1);
+    REQUIRE(index.ForHapticComponent(42)[0].event == &events[1]);
+    REQUIRE(index.ForHapticComponent(43).size() == 1);
+    REQUIRE(index.ForHapticComponent(44).empty());
+
+    // rebuilding forgets the previous frame
+    std::vector<vr::VREvent_t> next_events = { MakeHapticEvent(44) };
+    index.Build(next_events);
+    REQUIRE(index.ForDevice(3).empty());
+    REQUIRE(index.ForHapticComponent(42).empty());
+    REQUIRE(index.ForHapticComponent(44).size() == 1);
+}
@@ -0,0 +1,165 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <format>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AllocationCounter.hpp"
+#include "DriverFactory.hpp"
+#include "EventIndex.hpp"
+#include "FrameEventBuffer.hpp"
+#include "TrackerDevice.hpp"
+#include "VRDriver.hpp"
+#include "common/DriverGuard.hpp"
+#include "common/FakeDriverContext.hpp"
+
+using SlimeVRDriver::EventIndex;
+using SlimeVRDriver::FrameEventBuffer;
+
+namespace {
+
+vr::VREvent_t MakeEvent(uint32_t frame, vr::TrackedDeviceIndex_t index) {
+    vr::VREvent_t event{};
+    event.eventType = index % 2 ? vr::VREvent_Input_HapticVibration : vr::VREvent_PropertyChanged;
+    event.trackedDeviceIndex = index;
+    event.data.hapticVibration.componentHandle = index;
+    event.eventAgeSeconds = static_cast<float>(frame);
+    return event;
+}
+
+} // namespace
+
+TEST_CASE("Published events become current", "[FrameEventBuffer]") {
+    FrameEventBuffer buffer;
+    REQUIRE(buffer.GetCurrent().empty());
+
+    buffer.BeginFrame();
+    buffer.Push(MakeEvent(1, 0));
+    buffer.Push(MakeEvent(1, 1));
+    // still collecting, the previous frame stays current
+    REQUIRE(buffer.GetCurrent().empty());
+    buffer.Publish();
+    REQUIRE(buffer.GetCurrent().size() == 2);
+
+    buffer.BeginFrame();
+    buffer.Push(MakeEvent(2, 0));
+    REQUIRE(buffer.GetCurrent().size() == 2);
+    buffer.Publish();
+    REQUIRE(buffer.GetCurrent().size() == 1);
+    REQUIRE(buffer.GetCurrent()[0].eventAgeSeconds == 2.f);
+
+    std::vector<vr::VREvent_t> copy;
+    buffer.CopyCurrent(copy);
+    REQUIRE(copy.size() == 1);
+    REQUIRE(copy[0].eventAgeSeconds == 2.f);
+}
+
+TEST_CASE("Collecting and indexing events doesn't allocate once running", "[FrameEventBuffer]") {
+    FrameEventBuffer buffer;
+    EventIndex index;
+    const int devices = 20;
+
+    // the event handling of RunFrame on its own: collect, publish, index, dispatch
+    auto run_frame = [&](uint32_t frame, int event_count) {
+        buffer.BeginFrame();
+        for (int i = 0; i < event_count; i++) {
+            buffer.Push(MakeEvent(frame, i % devices));
+        }
+        buffer.Publish();
+        index.Build(buffer.GetCurrent());
+        size_t found = 0;
+        for (int device = 0; device < devices; device++) {
+            found += index.ForDevice(device).size() + index.ForHapticComponent(device).size();
+        }
+        return found;
+    };
+
+    // the busiest frame sizes every buffer, including one larger than the initial capacity
+    const int max_events = static_cast<int>(FrameEventBuffer::kInitialCapacity) * 2;
+    run_frame(0, max_events);
+    run_frame(1, max_events);
+
+    // make sure allocations are counted at all
+    uint64_t allocations_before = GetThreadAllocationCount();
+    auto probe = std::make_unique<int>(0);
+    REQUIRE(GetThreadAllocationCount() == allocations_before + 1);
+
+    allocations_before = GetThreadAllocationCount();
+    size_t found = 0;
+    for (uint32_t frame = 2; frame < 1000; frame++) {
+        found += run_frame(frame, static_cast<int>(frame * 7 % max_events));
+    }
+    REQUIRE(GetThreadAllocationCount() == allocations_before);
+    REQUIRE(found > 0);
+}
+
+TEST_CASE("RunFrame doesn't allocate once running", "[FrameEventBuffer][Driver]") {
+    FakeDriverContext context;
+    context.AddHeadset();
+    auto driver = std::make_shared<SlimeVRDriver::VRDriver>();
+    SlimeVRDriver::SetDriver(driver);
+    REQUIRE(driver->Init(&context) == vr::VRInitError_None);
+    DriverGuard guard(context, *driver);
+
+    const int devices = 20;
+    for (int id = 0; id < devices; id++) {
+        auto tracker = std::make_shared<SlimeVRDriver::TrackerDevice>(std::format("human://ALLOC_{}", id), id, TrackerRole::WAIST);
+        REQUIRE(driver->AddDevice(tracker));
+    }
+    REQUIRE(context.ActivateAddedDevices() == devices);
+
+    // events are queued on this thread too, only the allocations of RunFrame count. Haptic events don't match the
+    // trackers' haptic components and aren't forwarded. Bridge stats are logged once a minute, which does allocate.
+    auto run_frame = [&](uint32_t frame, int event_count) {
+        for (int i = 0; i < event_count; i++) {
+            auto event = MakeEvent(frame, i % (devices + 3));
+            context.PushEvent(static_cast<vr::EVREventType>(event.eventType), event.trackedDeviceIndex, event.data);
+        }
+        uint64_t allocations_before = GetThreadAllocationCount();
+        driver->RunFrame();
+        return GetThreadAllocationCount() - allocations_before;
+    };
+
+    // the first frames name the thread, signal that SteamVR is done initialising and size every buffer, which also
+    // shows allocations are counted at all
+    const int max_events = static_cast<int>(FrameEventBuffer::kInitialCapacity) * 2;
+    REQUIRE(run_frame(0, max_events) > 0);
+    run_frame(1, max_events);
+
+    uint64_t allocations = 0;
+    for (uint32_t frame = 2; frame < 1000; frame++) {
+        allocations += run_frame(frame, static_cast<int>(frame * 7 % max_events));
+    }
+    REQUIRE(allocations == 0);
+}
+
+TEST_CASE("Copies from other threads see whole frames", "[FrameEventBuffer]") {
+    FrameEventBuffer buffer;
+    std::atomic<bool> done = false;
+    std::atomic<int> torn = 0;
+
+    std::thread reader{ [&]() {
+        std::vector<vr::VREvent_t> copy;
+        while (!done) {
+            buffer.CopyCurrent(copy);
+            for (const auto& event : copy) {
+                if (event.eventAgeSeconds != copy[0].eventAgeSeconds)
+                    torn++;
+            }
+        }
+    } };
+
+    for (uint32_t frame = 0; frame < 20000; frame++) {
+        buffer.BeginFrame();
+        for (int i = 0; i < 16; i++) {
+            buffer.Push(MakeEvent(frame, i));
+        }
+        buffer.Publish();
+    }
+    done = true;
+    reader.join();
+
+    REQUIRE(torn == 0);
+}
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+
+using SlimeVRDriver::LatencyHistogram;
+using namespace std::chrono;
+
+TEST_CASE("Buckets cover every value with bounded error", "[LatencyHistogram]") {
+    size_t last_index = 0;
+    for (uint64_t value = 0; value < 100000; value++) {
+        size_t index = LatencyHistogram::BucketIndex(value);
+        REQUIRE(index < LatencyHistogram::kBucketCount);
+        // buckets are contiguous and ordered
+        REQUIRE((index == last_index || index == last_index + 1));
+        last_index = index;
+
+        uint64_t upper = LatencyHistogram::BucketUpperBound(index);
+        REQUIRE(upper >= value);
+        REQUIRE(upper - value <= value / LatencyHistogram::kSubBuckets);
+    }
+    REQUIRE(LatencyHistogram::BucketIndex(UINT64_MAX) == LatencyHistogram::kBucketCount - 1);
+}
+
+TEST_CASE("Percentiles of recorded latencies", "[LatencyHistogram]") {
+    LatencyHistogram histogram;
+    REQUIRE(histogram.Summarize().count == 0);
+
+    // 1..1000us once each
+    for (int us = 1; us <= 1000; us++) {
+        histogram.Record(microseconds(us));
+    }
+    histogram.Record(microseconds(-5));
+
+    auto summary = histogram.Summarize();
+    REQUIRE(summary.count == 1001);
+    REQUIRE(summary.max_us == 1000);
+    REQUIRE(summary.mean_us > 499.0);
+    REQUIRE(summary.mean_us < 501.0);
+    auto near = [](uint64_t value, uint64_t expected) {
+        return value >= expected && value <= expected + expected / LatencyHistogram::kSubBuckets;
+    };
+    REQUIRE(near(summary.p50_us, 500));
+    REQUIRE(near(summary.p90_us, 900));
+    REQUIRE(near(summary.p99_us, 990));
+    REQUIRE(summary.p999_us == 1000);
+
+    REQUIRE(histogram.ToJson().starts_with(R"({"count":1001,"mean_us":)"));
+    REQUIRE(histogram.ToJson().ends_with(R"("max_us":1000})"));
+}
+
+TEST_CASE("Recording from several threads", "[LatencyHistogram]") {
+    LatencyHistogram histogram;
+    const int threads = 4;
+    const int records = 100000;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; t++) {
+        writers.emplace_back([&, t]() {
+            for (int i = 0; i < records; i++) {
+                histogram.Record(microseconds(t * 1000 + i % 1000));
+            }
+        });
+    }
+    // reading while recording sees some consistent prefix of the records
+    while (histogram.Summarize().count < threads * records / 2) {
+        REQUIRE(histogram.Summarize().max_us < threads * 1000);
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    auto summary = histogram.Summarize();
+    REQUIRE(summary.count == threads * records);
+    REQUIRE(summary.max_us == threads * 1000 - 1);
+}
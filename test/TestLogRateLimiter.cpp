@@ -0,0 +1,90 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "LogRateLimiter.hpp"
+#include "Logger.hpp"
+
+using SlimeVRDriver::LogRateLimiter;
+using namespace std::chrono;
+
+namespace {
+
+class CapturingLogger : public Logger {
+public:
+    using Logger::Logger;
+    std::vector<std::string> messages;
+
+protected:
+    void LogImpl(const char* message) override {
+        messages.emplace_back(message);
+    }
+};
+
+} // namespace
+
+TEST_CASE("Repeats within the interval are counted", "[LogRateLimiter]") {
+    LogRateLimiter limiter;
+    limiter.SetInterval(seconds(10));
+    const char* site = "Failed to get Prop_DeviceClass_Int32 for device {}: {}";
+    auto start = steady_clock::time_point{} + hours(1);
+    uint64_t suppressed = 0;
+
+    REQUIRE(limiter.Allow(site, 3, start, suppressed));
+    REQUIRE(suppressed == 0);
+    // every 2ms like the pose request thread
+    for (int i = 1; i < 5000; i++) {
+        REQUIRE_FALSE(limiter.Allow(site, 3, start + milliseconds(i * 2), suppressed));
+    }
+    // other keys and call sites are limited separately
+    REQUIRE(limiter.Allow(site, 4, start + seconds(1), suppressed));
+    REQUIRE(limiter.Allow("Couldn't determine role for device {}", 3, start + seconds(1), suppressed));
+
+    REQUIRE(limiter.Allow(site, 3, start + seconds(10), suppressed));
+    REQUIRE(suppressed == 4999);
+    REQUIRE_FALSE(limiter.Allow(site, 3, start + seconds(11), suppressed));
+}
+
+TEST_CASE("Suppressed counts are reported once repeats stop", "[LogRateLimiter]") {
+    LogRateLimiter limiter;
+    limiter.SetInterval(seconds(10));
+    auto start = steady_clock::time_point{} + hours(1);
+    uint64_t suppressed;
+
+    limiter.Allow("a", 1, start, suppressed);
+    limiter.Allow("a", 1, start + seconds(1), suppressed);
+    limiter.Allow("a", 1, start + seconds(2), suppressed);
+    limiter.Allow("b", 1, start, suppressed);
+
+    REQUIRE(limiter.TakeSuppressed(start + seconds(5)).empty());
+    auto reported = limiter.TakeSuppressed(start + seconds(10));
+    REQUIRE(reported.size() == 1);
+    REQUIRE(std::string(reported[0].site) == "a");
+    REQUIRE(reported[0].key == 1);
+    REQUIRE(reported[0].count == 2);
+
+    // reported counts start over, messages without repeats are forgotten and written right away again
+    REQUIRE(limiter.TakeSuppressed(start + seconds(20)).empty());
+    REQUIRE(limiter.Allow("a", 1, start + seconds(21), suppressed));
+    REQUIRE(suppressed == 0);
+    REQUIRE(limiter.Allow("b", 1, start + seconds(21), suppressed));
+}
+
+TEST_CASE("Rate limited logging", "[LogRateLimiter]") {
+    CapturingLogger logger("Driver");
+    logger.SetRateLimitInterval(hours(1));
+    for (int i = 0; i < 100; i++) {
+        logger.LogRateLimited(7, "Failed to get Prop_DeviceClass_Int32 for device {}: {}", 7, "TrackedProp_WrongDataType");
+        logger.LogRateLimited(8, "Failed to get Prop_DeviceClass_Int32 for device {}: {}", 8, "TrackedProp_WrongDataType");
+    }
+    REQUIRE(logger.messages == std::vector<std::string>{
+                "Driver: Failed to get Prop_DeviceClass_Int32 for device 7: TrackedProp_WrongDataType",
+                "Driver: Failed to get Prop_DeviceClass_Int32 for device 8: TrackedProp_WrongDataType",
+            });
+
+    logger.SetRateLimitInterval(seconds(0));
+    logger.LogRateLimited(7, "Failed to get Prop_DeviceClass_Int32 for device {}: {}", 7, "TrackedProp_WrongDataType");
+    REQUIRE(logger.messages.back() == "Driver: Failed to get Prop_DeviceClass_Int32 for device 7: TrackedProp_WrongDataType (suppressed 99 times)");
+}
@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <format>
+#include <string>
+#include <vector>
+
+#include "Logger.hpp"
+
+namespace {
+
+class CapturingLogger : public Logger {
+public:
+    using Logger::Logger;
+    std::vector<std::string> messages;
+
+protected:
+    void LogImpl(const char* message) override {
+        messages.emplace_back(message);
+    }
+};
+
+// counts how often it's formatted
+struct Expensive {
+    int& formatted;
+};
+
+/**
+ * Restores the runtime level when a test ends.
+ */
+class LevelGuard {
+public:
+    LevelGuard()
+        : level_(Logger::GetLevel()) { }
+    ~LevelGuard() {
+        Logger::SetLevel(level_);
+    }
+
+private:
+    LogLevel level_;
+};
+
+} // namespace
+
+template <>
+struct std::formatter<Expensive> : std::formatter<int> {
+    auto format(const Expensive& value, std::format_context& ctx) const {
+        return std::formatter<int>::format(++value.formatted, ctx);
+    }
+};
+
+// formatting it doesn't compile, only calls that are compiled out can take it
+struct Unformattable { };
+
+template <>
+struct std::formatter<Unformattable> {
+    constexpr auto parse(std::format_parse_context& ctx) {
+        return ctx.begin();
+    }
+
+    template <typename Context>
+    typename Context::iterator format(const Unformattable&, Context&) const {
+        static_assert(sizeof(Context) == 0, "a message below kMinLogLevel was formatted");
+    }
+};
+
+namespace {
+
+template <LogLevel Level>
+void LogCompiledOut(Logger& logger) {
+    if constexpr (Level < kMinLogLevel)
+        logger.LogAt<Level>("{}", Unformattable{});
+}
+
+// LogRateLimited logs at Warning
+template <typename T>
+void LogRateLimitedCompiledOut(Logger& logger, T value) {
+    if constexpr (LogLevel::LOG_WARNING < kMinLogLevel)
+        logger.LogRateLimited(0, "{}", value);
+}
+
+} // namespace
+
+TEST_CASE("Messages below the runtime level aren't formatted", "[Logger]") {
+    LevelGuard guard;
+    CapturingLogger logger("Tracker");
+    int formatted = 0;
+
+    Logger::SetLevel(LogLevel::LOG_WARNING);
+    logger.Debug("debug {}", Expensive{ formatted });
+    logger.Log("info {}", Expensive{ formatted });
+    logger.Warning("warning {}", Expensive{ formatted });
+    logger.Error("error {}", Expensive{ formatted });
+    REQUIRE(formatted == 2);
+    REQUIRE(logger.messages == std::vector<std::string>{ "Tracker: warning 1", "Tracker: error 2" });
+
+    Logger::SetLevel(LogLevel::LOG_OFF);
+    logger.Error("error {}", Expensive{ formatted });
+    logger.LogRateLimited(0, "rate limited {}", Expensive{ formatted });
+    REQUIRE(formatted == 2);
+}
+
+TEST_CASE("Messages below the compile time level are compiled out", "[Logger]") {
+    LevelGuard guard;
+    CapturingLogger logger;
+    Logger::SetLevel(LogLevel::LOG_TRACE);
+
+    // builds only if no call below kMinLogLevel instantiates formatting, whatever level the tests are built with
+    LogCompiledOut<LogLevel::LOG_TRACE>(logger);
+    LogCompiledOut<LogLevel::LOG_DEBUG>(logger);
+    LogCompiledOut<LogLevel::LOG_INFO>(logger);
+    LogCompiledOut<LogLevel::LOG_WARNING>(logger);
+    LogCompiledOut<LogLevel::LOG_ERROR>(logger);
+    LogRateLimitedCompiledOut(logger, Unformattable{});
+    REQUIRE(logger.messages.empty());
+}
+
+TEST_CASE("Parsing log levels", "[Logger]") {
+    REQUIRE(ParseLogLevel("trace") == LogLevel::LOG_TRACE);
+    REQUIRE(ParseLogLevel("debug") == LogLevel::LOG_DEBUG);
+    REQUIRE(ParseLogLevel("info") == LogLevel::LOG_INFO);
+    REQUIRE(ParseLogLevel("warning") == LogLevel::LOG_WARNING);
+    REQUIRE(ParseLogLevel("error") == LogLevel::LOG_ERROR);
+    REQUIRE(ParseLogLevel("off") == LogLevel::LOG_OFF);
+    REQUIRE(ParseLogLevel("") == LogLevel::LOG_INFO);
+}
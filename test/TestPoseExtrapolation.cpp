@@ -0,0 +1,186 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <random>
+
+#include "IVRDevice.hpp"
+#include "PoseMath.hpp"
+
+using namespace SlimeVRDriver;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Tracker moving at a constant linear and angular velocity
+struct SyntheticMotion {
+    double velocity[3] = { 0.8, -0.2, 1.5 };
+    double angular_velocity[3] = { 0.3, kPi / 2, -0.6 };
+    vr::HmdQuaternion_t start_rotation = QuatNormalize({ 0.9, 0.1, 0.3, -0.2 });
+
+    vr::DriverPose_t At(double t) const {
+        vr::DriverPose_t pose = IVRDevice::MakeDefaultPose();
+        double rotation[3];
+        for (int i = 0; i < 3; i++) {
+            pose.vecPosition[i] = velocity[i] * t;
+            rotation[i] = angular_velocity[i] * t;
+        }
+        pose.qRotation = QuatNormalize(QuatMultiply(QuatFromRotationVector(rotation), start_rotation));
+        return pose;
+    }
+};
+
+double PositionError(const vr::DriverPose_t& a, const vr::DriverPose_t& b) {
+    double dx = a.vecPosition[0] - b.vecPosition[0];
+    double dy = a.vecPosition[1] - b.vecPosition[1];
+    double dz = a.vecPosition[2] - b.vecPosition[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+double RotationError(const vr::DriverPose_t& a, const vr::DriverPose_t& b) {
+    double v[3];
+    QuatToRotationVector(QuatMultiply(a.qRotation, QuatConjugate(b.qRotation)), v);
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+// What SteamVR does with a submitted pose: move it forward from its pose time to the time it is used
+vr::DriverPose_t ApplySteamVRPrediction(vr::DriverPose_t pose, double seconds_since_submit) {
+    ExtrapolatePose(pose, seconds_since_submit - pose.poseTimeOffset);
+    return pose;
+}
+
+} // namespace
+
+TEST_CASE("Rotation vector round trip", "[PoseMath]") {
+    double v[3] = { 0.4, -1.1, 0.25 };
+    double out[3];
+    QuatToRotationVector(QuatFromRotationVector(v), out);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(std::abs(out[i] - v[i]) < 1e-9);
+    }
+
+    double zero[3] = { 0.0, 0.0, 0.0 };
+    QuatToRotationVector(QuatFromRotationVector(zero), out);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(std::abs(out[i]) < 1e-12);
+    }
+}
+
+TEST_CASE("Derived angular velocity", "[PoseMath]") {
+    SyntheticMotion motion;
+    double dt = 0.01;
+    double angular_velocity[3];
+    AngularVelocityBetween(motion.At(1.0).qRotation, motion.At(1.0 + dt).qRotation, dt, angular_velocity);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(std::abs(angular_velocity[i] - motion.angular_velocity[i]) < 1e-6);
+    }
+}
+
+TEST_CASE("Extrapolation of an evenly timed stream", "[PoseMath]") {
+    SyntheticMotion motion;
+    const double interval = 0.01;
+    const double horizon = 0.05;
+
+    vr::DriverPose_t previous = motion.At(0.0);
+    for (int i = 1; i < 100; i++) {
+        double t = i * interval;
+        vr::DriverPose_t received = motion.At(t);
+        for (int axis = 0; axis < 3; axis++)
+            received.vecVelocity[axis] = motion.velocity[axis];
+        AngularVelocityBetween(previous.qRotation, received.qRotation, interval, received.vecAngularVelocity);
+        previous = received;
+
+        // submitted late by up to the horizon, then used by SteamVR a bit later still
+        for (double age : { 0.0, 0.004, 0.02, horizon }) {
+            vr::DriverPose_t submitted = ExtrapolatePoseForSubmit(received, age, horizon);
+            REQUIRE(submitted.poseTimeOffset == -age);
+            vr::DriverPose_t predicted = ApplySteamVRPrediction(submitted, 0.011);
+            vr::DriverPose_t truth = motion.At(t + age + 0.011);
+            REQUIRE(PositionError(predicted, truth) < 1e-6);
+            REQUIRE(RotationError(predicted, truth) < 1e-6);
+        }
+    }
+}
+
+TEST_CASE("Extrapolation of a jittered stream", "[PoseMath]") {
+    SyntheticMotion motion;
+    const double interval = 0.01;
+    const double horizon = 0.05;
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<double> jitter(-0.002, 0.002);
+
+    // arrival times are jittered, the driver only knows when poses arrived
+    vr::DriverPose_t previous = motion.At(0.0);
+    double previous_arrival = 0.0;
+    double held_error_sum = 0.0;
+    double extrapolated_error_sum = 0.0;
+    double max_extrapolated_error = 0.0;
+    int samples = 0;
+    for (int i = 1; i < 500; i++) {
+        double t = i * interval;
+        double arrival = t + jitter(rng);
+        vr::DriverPose_t received = motion.At(t);
+        AngularVelocityBetween(previous.qRotation, received.qRotation, arrival - previous_arrival, received.vecAngularVelocity);
+        previous = received;
+        previous_arrival = arrival;
+
+        for (double age : { 0.005, 0.01, 0.03 }) {
+            vr::DriverPose_t truth = motion.At(t + age);
+            vr::DriverPose_t held = received;
+            vr::DriverPose_t extrapolated = ApplySteamVRPrediction(ExtrapolatePoseForSubmit(received, age, horizon), 0.0);
+            double error = RotationError(extrapolated, truth);
+            held_error_sum += RotationError(held, truth);
+            extrapolated_error_sum += error;
+            max_extrapolated_error = std::max(max_extrapolated_error, error);
+            samples++;
+        }
+    }
+
+    // holding the last pose is what SteamVR did before
+    REQUIRE(extrapolated_error_sum / samples < 0.25 * held_error_sum / samples);
+    // 1.7 rad/s over at most 30ms, the derived rate is off by up to 67% when two arrivals are 6ms apart
+    REQUIRE(max_extrapolated_error < 0.035);
+}
+
+TEST_CASE("Extrapolation stops at the horizon", "[PoseMath]") {
+    SyntheticMotion motion;
+    const double horizon = 0.05;
+
+    vr::DriverPose_t received = motion.At(1.0);
+    for (int axis = 0; axis < 3; axis++) {
+        received.vecVelocity[axis] = motion.velocity[axis];
+        received.vecAngularVelocity[axis] = motion.angular_velocity[axis];
+    }
+
+    vr::DriverPose_t frozen = ExtrapolatePoseForSubmit(received, 0.5, horizon);
+    REQUIRE(frozen.poseTimeOffset == 0.0);
+    for (int axis = 0; axis < 3; axis++) {
+        REQUIRE(frozen.vecVelocity[axis] == 0.0);
+        REQUIRE(frozen.vecAngularVelocity[axis] == 0.0);
+    }
+
+    // SteamVR holds the frozen pose however long it is used for
+    vr::DriverPose_t truth = motion.At(1.0 + horizon);
+    REQUIRE(PositionError(ApplySteamVRPrediction(frozen, 1.0), truth) < 1e-6);
+    REQUIRE(RotationError(ApplySteamVRPrediction(frozen, 1.0), truth) < 1e-6);
+}
+
+TEST_CASE("Extrapolation follows acceleration", "[PoseMath]") {
+    // speeding up along x and around y from 1m/s and 1rad/s, 4m/s² and 2rad/s² at t = 0
+    auto at = [](double t) {
+        vr::DriverPose_t pose = IVRDevice::MakeDefaultPose();
+        pose.vecPosition[0] = t + 2.0 * t * t;
+        double rotation[3] = { 0.0, t + t * t, 0.0 };
+        pose.qRotation = QuatFromRotationVector(rotation);
+        return pose;
+    };
+
+    vr::DriverPose_t pose = at(0.0);
+    pose.vecVelocity[0] = 1.0;
+    pose.vecAcceleration[0] = 4.0;
+    pose.vecAngularVelocity[1] = 1.0;
+    pose.vecAngularAcceleration[1] = 2.0;
+    ExtrapolatePose(pose, 0.1);
+    REQUIRE(PositionError(pose, at(0.1)) < 1e-9);
+    REQUIRE(RotationError(pose, at(0.1)) < 1e-9);
+}
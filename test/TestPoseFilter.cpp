@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+
+#include "IVRDevice.hpp"
+#include "PoseFilter.hpp"
+
+using namespace SlimeVRDriver;
+
+namespace {
+
+const OneEuroParams kPositionParams{ 1.5, 10.0, 1.0 };
+const OneEuroParams kRotationParams{ 1.5, 5.0, 1.0 };
+const double kInterval = 0.01;
+
+double RotationError(const vr::HmdQuaternion_t& a, const vr::HmdQuaternion_t& b) {
+    double v[3];
+    QuatToRotationVector(QuatMultiply(a, QuatConjugate(b)), v);
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+vr::HmdQuaternion_t YawRotation(double angle) {
+    double v[3] = { 0.0, angle, 0.0 };
+    return QuatFromRotationVector(v);
+}
+
+} // namespace
+
+TEST_CASE("Slerp", "[PoseFilter]") {
+    vr::HmdQuaternion_t a = YawRotation(0.2);
+    vr::HmdQuaternion_t b = YawRotation(1.0);
+    REQUIRE(RotationError(QuatSlerp(a, b, 0.0), a) < 1e-9);
+    REQUIRE(RotationError(QuatSlerp(a, b, 1.0), b) < 1e-9);
+    REQUIRE(RotationError(QuatSlerp(a, b, 0.25), YawRotation(0.4)) < 1e-9);
+
+    // same rotation from the other hemisphere
+    vr::HmdQuaternion_t negated_b = { -b.w, -b.x, -b.y, -b.z };
+    REQUIRE(RotationError(QuatSlerp(a, negated_b, 0.5), YawRotation(0.6)) < 1e-9);
+}
+
+TEST_CASE("Disabled filter passes poses through", "[PoseFilter]") {
+    PoseFilter filter;
+    vr::DriverPose_t pose = IVRDevice::MakeDefaultPose();
+    pose.vecPosition[0] = 1.0;
+    pose.qRotation = YawRotation(0.5);
+    vr::DriverPose_t filtered = pose;
+    filter.Filter(filtered, kInterval);
+    REQUIRE(filtered.vecPosition[0] == 1.0);
+    REQUIRE(RotationError(filtered.qRotation, pose.qRotation) == 0.0);
+}
+
+TEST_CASE("Jitter at rest is smoothed", "[PoseFilter]") {
+    PoseFilter filter;
+    filter.Enable(kPositionParams, kRotationParams);
+    std::mt19937 rng(42);
+    std::normal_distribution<double> noise(0.0, 0.001);
+
+    double raw_error = 0.0;
+    double filtered_error = 0.0;
+    double raw_rotation_error = 0.0;
+    double filtered_rotation_error = 0.0;
+    for (int i = 0; i < 1000; i++) {
+        vr::DriverPose_t pose = IVRDevice::MakeDefaultPose();
+        for (double& component : pose.vecPosition)
+            component = noise(rng);
+        double jitter[3] = { noise(rng), noise(rng), noise(rng) };
+        pose.qRotation = QuatFromRotationVector(jitter);
+        vr::DriverPose_t raw = pose;
+        filter.Filter(pose, kInterval);
+
+        if (i < 100)
+            continue;
+        raw_error += std::abs(raw.vecPosition[0]);
+        filtered_error += std::abs(pose.vecPosition[0]);
+        raw_rotation_error += RotationError(raw.qRotation, { 1.0, 0.0, 0.0, 0.0 });
+        filtered_rotation_error += RotationError(pose.qRotation, { 1.0, 0.0, 0.0, 0.0 });
+    }
+
+    REQUIRE(filtered_error < 0.3 * raw_error);
+    REQUIRE(filtered_rotation_error < 0.3 * raw_rotation_error);
+}
+
+TEST_CASE("Fast motion adds little lag", "[PoseFilter]") {
+    PoseFilter filter;
+    filter.Enable(kPositionParams, kRotationParams);
+    const double speed = 2.0; // m/s
+    const double angular_speed = 6.0; // rad/s
+
+    double max_lag = 0.0;
+    double max_rotation_lag = 0.0;
+    for (int i = 0; i < 200; i++) {
+        double t = i * kInterval;
+        vr::DriverPose_t pose = IVRDevice::MakeDefaultPose();
+        pose.vecPosition[0] = speed * t;
+        pose.qRotation = YawRotation(angular_speed * t);
+        vr::DriverPose_t raw = pose;
+        filter.Filter(pose, kInterval);
+        if (i < 100)
+            continue;
+        max_lag = std::max(max_lag, raw.vecPosition[0] - pose.vecPosition[0]);
+        max_rotation_lag = std::max(max_rotation_lag, RotationError(raw.qRotation, pose.qRotation));
+    }
+
+    // less than one 100Hz sample of lag, a plain 1.5Hz low-pass would lag about 0.1s behind
+    REQUIRE(max_lag < speed * kInterval);
+    REQUIRE(max_rotation_lag < angular_speed * kInterval);
+}
+
+TEST_CASE("Long gaps reset the filter", "[PoseFilter]") {
+    PoseFilter filter;
+    filter.Enable(kPositionParams, kRotationParams);
+    vr::DriverPose_t pose = IVRDevice::MakeDefaultPose();
+    filter.Filter(pose, kInterval);
+
+    pose.vecPosition[1] = 1.0;
+    pose.qRotation = YawRotation(1.0);
+    filter.Filter(pose, 1.0);
+    REQUIRE(pose.vecPosition[1] == 1.0);
+    REQUIRE(RotationError(pose.qRotation, YawRotation(1.0)) < 1e-12);
+}
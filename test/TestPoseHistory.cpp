@@ -0,0 +1,151 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+#include "IVRDevice.hpp"
+#include "PoseHistory.hpp"
+
+using namespace SlimeVRDriver;
+using std::chrono::steady_clock;
+
+namespace {
+
+const steady_clock::time_point kStart = steady_clock::time_point(std::chrono::seconds(1000));
+
+steady_clock::time_point At(double seconds) {
+    return kStart + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+double Seconds(steady_clock::time_point time) {
+    return std::chrono::duration<double>(time - kStart).count();
+}
+
+// Moving along x at 1m/s and turning around y at 1rad/s, so both encode the time
+TimedPose PoseAt(double seconds, steady_clock::time_point time) {
+    TimedPose timed_pose{ IVRDevice::MakeDefaultPose(), time };
+    timed_pose.pose.vecPosition[0] = seconds;
+    double rotation[3] = { 0.0, seconds, 0.0 };
+    timed_pose.pose.qRotation = QuatFromRotationVector(rotation);
+    return timed_pose;
+}
+
+TimedPose PoseAt(double seconds) {
+    return PoseAt(seconds, At(seconds));
+}
+
+double Yaw(const TimedPose& timed_pose) {
+    double rotation[3];
+    QuatToRotationVector(timed_pose.pose.qRotation, rotation);
+    return rotation[1];
+}
+
+} // namespace
+
+TEST_CASE("Sampling between poses interpolates", "[PoseHistory]") {
+    PoseHistory history;
+    TimedPose sample;
+    REQUIRE(history.Sample(At(0.0), sample) == PoseHistory::SampleResult::EMPTY);
+
+    history.Push(PoseAt(0.00));
+    history.Push(PoseAt(0.01));
+    history.Push(PoseAt(0.03));
+
+    REQUIRE(history.Sample(At(0.005), sample) == PoseHistory::SampleResult::INTERPOLATED);
+    REQUIRE(std::abs(sample.pose.vecPosition[0] - 0.005) < 1e-9);
+    REQUIRE(std::abs(Yaw(sample) - 0.005) < 1e-9);
+
+    REQUIRE(history.Sample(At(0.025), sample) == PoseHistory::SampleResult::INTERPOLATED);
+    REQUIRE(std::abs(sample.pose.vecPosition[0] - 0.025) < 1e-9);
+    REQUIRE(std::abs(Yaw(sample) - 0.025) < 1e-9);
+
+    REQUIRE(history.Sample(At(0.04), sample) == PoseHistory::SampleResult::AFTER_NEWEST);
+    REQUIRE(sample.pose.vecPosition[0] == 0.03);
+
+    REQUIRE(history.Sample(At(-0.01), sample) == PoseHistory::SampleResult::BEFORE_OLDEST);
+    REQUIRE(sample.pose.vecPosition[0] == 0.0);
+}
+
+TEST_CASE("Only the newest poses are kept", "[PoseHistory]") {
+    PoseHistory history;
+    const int pushed = 100;
+    for (int i = 0; i < pushed; i++) {
+        history.Push(PoseAt(i * 0.01));
+    }
+
+    double oldest_kept = (pushed - PoseHistory::kCapacity) * 0.01;
+    TimedPose sample;
+    REQUIRE(history.Sample(At(0.0), sample) == PoseHistory::SampleResult::BEFORE_OLDEST);
+    REQUIRE(std::abs(sample.pose.vecPosition[0] - oldest_kept) < 1e-9);
+    REQUIRE(history.Sample(At(oldest_kept + 0.005), sample) == PoseHistory::SampleResult::INTERPOLATED);
+    REQUIRE(std::abs(sample.pose.vecPosition[0] - (oldest_kept + 0.005)) < 1e-9);
+}
+
+TEST_CASE("Resampling evens out irregular arrivals", "[PoseHistory]") {
+    // 100Hz poses arriving with jitter, consumed at 250Hz with a 20ms delay
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<double> jitter(-0.003, 0.003);
+    const double delay = 0.02;
+    const double tick = 0.004;
+
+    PoseHistory history;
+    TimedPose held = PoseAt(0.0);
+    double next_pose = 0.0;
+    double last_held = 0.0;
+    double last_resampled = 0.0;
+    double held_step_error = 0.0;
+    double resampled_step_error = 0.0;
+    int steps = 0;
+    for (double now = 0.0; now < 5.0; now += tick) {
+        while (next_pose <= now) {
+            double arrival = next_pose + jitter(rng);
+            held = PoseAt(next_pose, At(arrival));
+            history.Push(held);
+            next_pose += 0.01;
+        }
+
+        TimedPose sample;
+        history.Sample(At(now - delay), sample);
+        if (now > 0.1) {
+            // ideal output moves the same distance every tick
+            held_step_error += std::abs(held.pose.vecPosition[0] - last_held - tick);
+            resampled_step_error += std::abs(sample.pose.vecPosition[0] - last_resampled - tick);
+            steps++;
+        }
+        last_held = held.pose.vecPosition[0];
+        last_resampled = sample.pose.vecPosition[0];
+    }
+
+    REQUIRE(resampled_step_error / steps < 0.3 * held_step_error / steps);
+}
+
+TEST_CASE("Sampling while poses are pushed", "[PoseHistory]") {
+    PoseHistory history;
+    const int pushed = 50000;
+    std::atomic<int> written = 0;
+    std::atomic<int> errors = 0;
+
+    std::thread reader{ [&]() {
+        std::mt19937 rng(5);
+        while (written < pushed) {
+            double newest = written * 0.001;
+            std::uniform_real_distribution<double> offset(-0.05, 0.005);
+            TimedPose sample;
+            if (history.Sample(At(newest + offset(rng)), sample) == PoseHistory::SampleResult::EMPTY)
+                continue;
+            // every pose encodes its own time, interpolation between two consistent poses keeps that true
+            if (std::abs(sample.pose.vecPosition[0] - Seconds(sample.time)) > 1e-6)
+                errors++;
+        }
+    } };
+
+    for (int i = 0; i < pushed; i++) {
+        history.Push(PoseAt(i * 0.001));
+        written = i + 1;
+    }
+    reader.join();
+
+    REQUIRE(errors == 0);
+}
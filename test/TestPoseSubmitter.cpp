@@ -0,0 +1,134 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include "PoseSubmitter.hpp"
+#include "TrackerRole.hpp"
+#include "common/DriverHarness.hpp"
+
+using namespace std::chrono;
+using SlimeVRDriver::PoseSubmitMode;
+
+namespace {
+
+/**
+ * Adds a tracker through the server and waits until SteamVR activated it, running frames by hand.
+ */
+vr::TrackedDeviceIndex_t AddTracker(DriverHarness& harness) {
+    REQUIRE(WaitFor([&]() { return harness.server->IsConnected(); }));
+    SendTracker(*harness.server, 3, TrackerRole::WAIST, "human://WAIST");
+    REQUIRE(WaitFor([&]() {
+        harness.context.ActivateAddedDevices();
+        harness.driver->RunFrame();
+        return harness.context.CountActivatedDevices() == 1;
+    }));
+    auto tracker = harness.context.FindDriverDevice("human://WAIST");
+    // once a pose sent after the status is submitted, nothing the tracker was added with is left pending
+    SendPosition(*harness.server, 3, -1.f);
+    REQUIRE(WaitFor([&]() {
+        harness.driver->RunFrame();
+        return harness.context.GetSubmittedPoses(tracker).last.vecPosition[0] == -1.0;
+    }));
+    return tracker;
+}
+
+} // namespace
+
+TEST_CASE("Pose submit mode names", "[PoseSubmitter]") {
+    REQUIRE(SlimeVRDriver::ParsePoseSubmitMode("frame") == PoseSubmitMode::FRAME);
+    REQUIRE(SlimeVRDriver::ParsePoseSubmitMode("thread") == PoseSubmitMode::THREAD);
+    REQUIRE(SlimeVRDriver::ParsePoseSubmitMode("immediate") == PoseSubmitMode::IMMEDIATE);
+    REQUIRE(SlimeVRDriver::ParsePoseSubmitMode("bogus") == PoseSubmitMode::IMMEDIATE);
+    for (auto mode : { PoseSubmitMode::IMMEDIATE, PoseSubmitMode::FRAME, PoseSubmitMode::THREAD })
+        REQUIRE(SlimeVRDriver::ParsePoseSubmitMode(SlimeVRDriver::GetPoseSubmitModeName(mode)) == mode);
+}
+
+TEST_CASE("Immediate mode submits every pose", "[PoseSubmitter]") {
+    DriverHarness harness;
+    harness.Start();
+    REQUIRE(harness.driver->GetPoseSubmitter().IsImmediate());
+
+    auto tracker = AddTracker(harness);
+    auto before = harness.context.GetSubmittedPoses(tracker).count;
+    auto stats_before = harness.driver->GetPoseSubmitter().GetStats();
+    for (int i = 1; i <= 10; i++)
+        SendPosition(*harness.server, 3, static_cast<float>(i));
+
+    REQUIRE(WaitFor([&]() { return harness.context.GetSubmittedPoses(tracker).last.vecPosition[0] == 10.0; }));
+    REQUIRE(harness.context.GetSubmittedPoses(tracker).count == before + 10);
+    auto stats = harness.driver->GetPoseSubmitter().GetStats();
+    REQUIRE(stats.received - stats_before.received == 10);
+    REQUIRE(stats.submitted - stats_before.submitted == 10);
+    REQUIRE(stats.coalesced == stats_before.coalesced);
+}
+
+TEST_CASE("Frame mode submits the newest pose once per frame", "[PoseSubmitter]") {
+    DriverHarness harness;
+    harness.context.GetSettings().SetString("driver_slimevr", "poseSubmitMode", "frame");
+    harness.Start();
+    REQUIRE(harness.driver->GetPoseSubmitter().GetMode() == PoseSubmitMode::FRAME);
+
+    auto tracker = AddTracker(harness);
+    auto before = harness.context.GetSubmittedPoses(tracker).count;
+    auto stats_before = harness.driver->GetPoseSubmitter().GetStats();
+    for (int i = 1; i <= 5; i++)
+        SendPosition(*harness.server, 3, static_cast<float>(i));
+    REQUIRE(WaitFor([&]() { return harness.driver->GetPoseSubmitter().GetStats().received - stats_before.received == 5; }));
+
+    // nothing is submitted until the next frame, which submits only the newest pose
+    REQUIRE(harness.context.GetSubmittedPoses(tracker).count == before);
+    harness.driver->RunFrame();
+    REQUIRE(harness.context.GetSubmittedPoses(tracker).count == before + 1);
+    REQUIRE(harness.context.GetSubmittedPoses(tracker).last.vecPosition[0] == 5.0);
+    auto stats = harness.driver->GetPoseSubmitter().GetStats();
+    REQUIRE(stats.submitted - stats_before.submitted == 1);
+    REQUIRE(stats.coalesced - stats_before.coalesced == 4);
+
+    // no new pose, nothing to submit
+    harness.driver->RunFrame();
+    REQUIRE(harness.context.GetSubmittedPoses(tracker).count == before + 1);
+}
+
+TEST_CASE("Thread mode submits at the configured rate", "[PoseSubmitter]") {
+    DriverHarness harness;
+    harness.context.GetSettings().SetString("driver_slimevr", "poseSubmitMode", "thread");
+    harness.context.GetSettings().SetFloat("driver_slimevr", "poseSubmitRate", 50.f);
+    harness.Start();
+    REQUIRE(harness.driver->GetPoseSubmitter().GetMode() == PoseSubmitMode::THREAD);
+
+    auto tracker = AddTracker(harness);
+    auto before = harness.context.GetSubmittedPoses(tracker).count;
+    auto stats_before = harness.driver->GetPoseSubmitter().GetStats();
+    // 500Hz for 400ms, about 20 submissions at 50Hz
+    auto start = steady_clock::now();
+    for (int i = 1; i <= 200; i++) {
+        SendPosition(*harness.server, 3, static_cast<float>(i));
+        std::this_thread::sleep_until(start + 2ms * i);
+    }
+    REQUIRE(WaitFor([&]() { return harness.context.GetSubmittedPoses(tracker).last.vecPosition[0] == 200.0; }));
+
+    // loose bounds, only the order of magnitude is checked on a loaded machine
+    auto submitted = harness.context.GetSubmittedPoses(tracker).count - before;
+    REQUIRE(submitted >= 5);
+    REQUIRE(submitted <= 60);
+    auto stats = harness.driver->GetPoseSubmitter().GetStats();
+    REQUIRE(stats.received - stats_before.received == 200);
+    REQUIRE(stats.submitted - stats_before.submitted == submitted);
+    REQUIRE(stats.coalesced - stats_before.coalesced >= 200 - submitted);
+
+    // Cleanup joins the submission thread, nothing is submitted after it
+    harness.Stop();
+    REQUIRE(harness.context.HasLogged("Pose submission thread exiting"));
+    auto submitted_at_stop = harness.context.GetSubmittedPoses(tracker).count;
+    std::this_thread::sleep_for(50ms);
+    REQUIRE(harness.context.GetSubmittedPoses(tracker).count == submitted_at_stop);
+}
+
+TEST_CASE("Thread mode with an invalid rate falls back to frame mode", "[PoseSubmitter]") {
+    DriverHarness harness;
+    harness.context.GetSettings().SetString("driver_slimevr", "poseSubmitMode", "thread");
+    harness.context.GetSettings().SetFloat("driver_slimevr", "poseSubmitRate", 0.f);
+    harness.Start();
+    REQUIRE(harness.driver->GetPoseSubmitter().GetMode() == PoseSubmitMode::FRAME);
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include "PropertyShadow.hpp"
+
+using SlimeVRDriver::PropertyShadow;
+
+namespace {
+
+// Records property writes instead of sending them to SteamVR
+class RecordingProperties : public vr::IVRProperties {
+public:
+    vr::ETrackedPropertyError ReadPropertyBatch(vr::PropertyContainerHandle_t, vr::PropertyRead_t*, uint32_t) override {
+        return vr::TrackedProp_Success;
+    }
+
+    vr::ETrackedPropertyError WritePropertyBatch(vr::PropertyContainerHandle_t container, vr::PropertyWrite_t* batch, uint32_t count) override {
+        batches++;
+        // fails before looking at the entries, like an invalid container
+        if (fail_batch)
+            return vr::TrackedProp_InvalidDevice;
+        for (uint32_t i = 0; i < count; i++) {
+            auto& write = batch[i];
+            if (fail_next.count(write.prop)) {
+                fail_next.erase(write.prop);
+                write.eError = vr::TrackedProp_InvalidOperation;
+                continue;
+            }
+            std::vector<char> value(write.unBufferSize);
+            std::memcpy(value.data(), write.pvBuffer, write.unBufferSize);
+            values[{ container, write.prop }] = value;
+            write.eError = vr::TrackedProp_Success;
+            writes++;
+        }
+        return vr::TrackedProp_Success;
+    }
+
+    const char* GetPropErrorNameFromEnum(vr::ETrackedPropertyError) override {
+        return "";
+    }
+
+    vr::PropertyContainerHandle_t TrackedDeviceToPropertyContainer(vr::TrackedDeviceIndex_t index) override {
+        return index + 1;
+    }
+
+    template <typename T>
+    T Get(vr::PropertyContainerHandle_t container, vr::ETrackedDeviceProperty prop) {
+        auto& value = values.at({ container, prop });
+        REQUIRE(value.size() == sizeof(T));
+        T result;
+        std::memcpy(&result, value.data(), sizeof(T));
+        return result;
+    }
+
+    bool fail_batch = false;
+    int batches = 0;
+    int writes = 0;
+    std::map<vr::ETrackedDeviceProperty, bool> fail_next;
+    std::map<std::pair<vr::PropertyContainerHandle_t, vr::ETrackedDeviceProperty>, std::vector<char>> values;
+};
+
+} // namespace
+
+TEST_CASE("Changed values are written in one batch", "[PropertyShadow]") {
+    RecordingProperties properties;
+    PropertyShadow shadow;
+
+    shadow.SetBool(vr::Prop_DeviceProvidesBatteryStatus_Bool, true);
+    shadow.SetBool(vr::Prop_DeviceIsCharging_Bool, false);
+    shadow.SetFloat(vr::Prop_DeviceBatteryPercentage_Float, 0.5f);
+    REQUIRE(shadow.Commit(1, &properties) == 3);
+    REQUIRE(properties.batches == 1);
+    REQUIRE(properties.Get<bool>(1, vr::Prop_DeviceProvidesBatteryStatus_Bool) == true);
+    REQUIRE(properties.Get<bool>(1, vr::Prop_DeviceIsCharging_Bool) == false);
+    REQUIRE(properties.Get<float>(1, vr::Prop_DeviceBatteryPercentage_Float) == 0.5f);
+
+    // same values again, nothing to write
+    shadow.SetBool(vr::Prop_DeviceProvidesBatteryStatus_Bool, true);
+    shadow.SetBool(vr::Prop_DeviceIsCharging_Bool, false);
+    shadow.SetFloat(vr::Prop_DeviceBatteryPercentage_Float, 0.5f);
+    REQUIRE(shadow.Commit(1, &properties) == 0);
+    REQUIRE(properties.batches == 1);
+
+    // only the battery level changed
+    shadow.SetBool(vr::Prop_DeviceProvidesBatteryStatus_Bool, true);
+    shadow.SetBool(vr::Prop_DeviceIsCharging_Bool, false);
+    shadow.SetFloat(vr::Prop_DeviceBatteryPercentage_Float, 0.49f);
+    REQUIRE(shadow.Commit(1, &properties) == 1);
+    REQUIRE(properties.batches == 2);
+    REQUIRE(properties.writes == 4);
+    REQUIRE(properties.Get<float>(1, vr::Prop_DeviceBatteryPercentage_Float) == 0.49f);
+}
+
+TEST_CASE("Changing back before a commit writes nothing", "[PropertyShadow]") {
+    RecordingProperties properties;
+    PropertyShadow shadow;
+    shadow.SetBool(vr::Prop_DeviceIsCharging_Bool, false);
+    REQUIRE(shadow.Commit(1, &properties) == 1);
+
+    shadow.SetBool(vr::Prop_DeviceIsCharging_Bool, true);
+    shadow.SetBool(vr::Prop_DeviceIsCharging_Bool, false);
+    REQUIRE(shadow.Commit(1, &properties) == 0);
+    REQUIRE(properties.batches == 1);
+}
+
+TEST_CASE("Failed writes are retried", "[PropertyShadow]") {
+    RecordingProperties properties;
+    PropertyShadow shadow;
+    properties.fail_next[vr::Prop_DeviceIsCharging_Bool] = true;
+
+    shadow.SetBool(vr::Prop_DeviceIsCharging_Bool, true);
+    shadow.SetFloat(vr::Prop_DeviceBatteryPercentage_Float, 1.f);
+    REQUIRE(shadow.Commit(1, &properties) == 1);
+
+    REQUIRE(shadow.Commit(1, &properties) == 1);
+    REQUIRE(properties.Get<bool>(1, vr::Prop_DeviceIsCharging_Bool) == true);
+    REQUIRE(shadow.Commit(1, &properties) == 0);
+}
+
+TEST_CASE("A failed batch is retried", "[PropertyShadow]") {
+    RecordingProperties properties;
+    PropertyShadow shadow;
+    properties.fail_batch = true;
+
+    shadow.SetBool(vr::Prop_DeviceProvidesBatteryStatus_Bool, true);
+    shadow.SetFloat(vr::Prop_DeviceBatteryPercentage_Float, 0.8f);
+    REQUIRE(shadow.Commit(1, &properties) == 0);
+    REQUIRE(properties.batches == 1);
+    REQUIRE(properties.writes == 0);
+
+    properties.fail_batch = false;
+    REQUIRE(shadow.Commit(1, &properties) == 2);
+    REQUIRE(properties.Get<bool>(1, vr::Prop_DeviceProvidesBatteryStatus_Bool) == true);
+    REQUIRE(properties.Get<float>(1, vr::Prop_DeviceBatteryPercentage_Float) == 0.8f);
+    REQUIRE(shadow.Commit(1, &properties) == 0);
+}
+
+TEST_CASE("A new container gets every property again", "[PropertyShadow]") {
+    RecordingProperties properties;
+    PropertyShadow shadow;
+    shadow.SetBool(vr::Prop_DeviceProvidesBatteryStatus_Bool, true);
+    shadow.SetFloat(vr::Prop_DeviceBatteryPercentage_Float, 0.8f);
+    REQUIRE(shadow.Commit(1, &properties) == 2);
+
+    // e.g. the device was reactivated under another index
+    REQUIRE(shadow.Commit(2, &properties) == 2);
+    REQUIRE(properties.Get<bool>(2, vr::Prop_DeviceProvidesBatteryStatus_Bool) == true);
+    REQUIRE(properties.Get<float>(2, vr::Prop_DeviceBatteryPercentage_Float) == 0.8f);
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "IVRDevice.hpp"
+#include "PoseMath.hpp"
+#include "SeqLock.hpp"
+
+using SlimeVRDriver::IVRDevice;
+using SlimeVRDriver::SeqLock;
+using SlimeVRDriver::TimedPose;
+
+namespace {
+
+// Every field a torn read could mix up carries the same value
+TimedPose MakeStampedPose(int64_t stamp) {
+    TimedPose timed_pose{ IVRDevice::MakeDefaultPose(), std::chrono::steady_clock::time_point(std::chrono::nanoseconds(stamp)) };
+    vr::DriverPose_t& pose = timed_pose.pose;
+    double value = static_cast<double>(stamp);
+    pose.poseTimeOffset = value;
+    pose.qRotation = { value, value, value, value };
+    for (int i = 0; i < 3; i++) {
+        pose.vecPosition[i] = value;
+        pose.vecVelocity[i] = value;
+        pose.vecAcceleration[i] = value;
+        pose.vecAngularVelocity[i] = value;
+        pose.vecAngularAcceleration[i] = value;
+    }
+    return timed_pose;
+}
+
+bool IsConsistent(const TimedPose& timed_pose, int64_t& stamp) {
+    const vr::DriverPose_t& pose = timed_pose.pose;
+    stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(timed_pose.time.time_since_epoch()).count();
+    double value = static_cast<double>(stamp);
+    if (pose.poseTimeOffset != value || pose.qRotation.w != value || pose.qRotation.x != value
+        || pose.qRotation.y != value || pose.qRotation.z != value)
+        return false;
+    for (int i = 0; i < 3; i++) {
+        if (pose.vecPosition[i] != value || pose.vecVelocity[i] != value || pose.vecAcceleration[i] != value
+            || pose.vecAngularVelocity[i] != value || pose.vecAngularAcceleration[i] != value)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("Store/Load", "[SeqLock]") {
+    SeqLock<TimedPose> slot{ MakeStampedPose(1) };
+    int64_t stamp;
+    REQUIRE(IsConsistent(slot.Load(), stamp));
+    REQUIRE(stamp == 1);
+    REQUIRE(slot.GetVersion() == 1);
+
+    slot.Store(MakeStampedPose(42));
+    REQUIRE(IsConsistent(slot.Load(), stamp));
+    REQUIRE(stamp == 42);
+    REQUIRE(slot.GetVersion() == 2);
+
+    // sizes that aren't a multiple of the word size
+    SeqLock<char> small{ 'a' };
+    REQUIRE(small.Load() == 'a');
+    small.Store('b');
+    REQUIRE(small.Load() == 'b');
+}
+
+TEST_CASE("Readers never see torn values", "[SeqLock]") {
+    const int writes = 20000;
+    const int writer_count = 2;
+    const int reader_count = 3;
+    SeqLock<TimedPose> slot{ MakeStampedPose(0) };
+    std::atomic<bool> done = false;
+    std::atomic<int> torn = 0;
+    std::atomic<int> went_back = 0;
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_count; r++) {
+        readers.emplace_back([&]() {
+            // each writer stores increasing stamps, so a reader must never see an older one from the same writer
+            std::vector<int64_t> last_seen(writer_count, 0);
+            while (!done) {
+                int64_t stamp;
+                if (!IsConsistent(slot.Load(), stamp)) {
+                    torn++;
+                    continue;
+                }
+                if (stamp == 0)
+                    continue;
+                int64_t& last = last_seen[(stamp - 1) / writes];
+                if (stamp < last)
+                    went_back++;
+                last = stamp;
+            }
+        });
+    }
+
+    uint64_t last_version = slot.GetVersion();
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writer_count; w++) {
+        writers.emplace_back([&, w]() {
+            for (int i = 1; i <= writes; i++) {
+                slot.Store(MakeStampedPose(static_cast<int64_t>(w) * writes + i));
+            }
+        });
+    }
+    for (auto& writer : writers)
+        writer.join();
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    REQUIRE(torn == 0);
+    REQUIRE(went_back == 0);
+    REQUIRE(slot.GetVersion() == last_version + writer_count * writes);
+}
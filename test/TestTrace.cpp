@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "Trace.hpp"
+
+using SlimeVRDriver::Trace;
+using namespace std::chrono;
+
+namespace {
+
+size_t CountOccurrences(const std::string& haystack, const std::string& needle) {
+    size_t count = 0;
+    for (size_t pos = haystack.find(needle); pos != std::string::npos; pos = haystack.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Spans of several threads are exported", "[Trace]") {
+    Trace::SetEnabled(true);
+    std::thread io{ []() {
+        Trace::SetThreadName("Test IO");
+        Trace::SetThreadName("ignored");
+        for (int i = 0; i < 10; i++) {
+            TRACE_SCOPE("TestOnRecv");
+        }
+    } };
+    io.join();
+    {
+        TRACE_SCOPE("TestRunFrame");
+        std::this_thread::sleep_for(milliseconds(2));
+    }
+    Trace::SetEnabled(false);
+    {
+        TRACE_SCOPE("TestDisabled");
+    }
+
+    std::string json = Trace::ToChromeJson();
+    REQUIRE(json.starts_with(R"({"displayTimeUnit":"ms","traceEvents":[)"));
+    REQUIRE(json.ends_with("]}"));
+    // spans of exited threads are kept
+    REQUIRE(CountOccurrences(json, R"("name":"TestOnRecv","ph":"X")") == 10);
+    REQUIRE(CountOccurrences(json, R"("args":{"name":"Test IO"})") == 1);
+    REQUIRE(CountOccurrences(json, R"("name":"TestRunFrame","ph":"X")") == 1);
+    REQUIRE(CountOccurrences(json, "TestDisabled") == 0);
+    REQUIRE(CountOccurrences(json, "ignored") == 0);
+
+    auto path = std::filesystem::temp_directory_path() / "slimevr_test_trace.json";
+    REQUIRE(Trace::WriteChromeTrace(path));
+    std::stringstream written;
+    written << std::ifstream(path).rdbuf();
+    REQUIRE(written.str().size() >= json.size());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Only the newest spans of a thread are kept", "[Trace]") {
+    Trace::SetEnabled(true);
+    std::thread worker{ []() {
+        auto start = steady_clock::now();
+        Trace::Record("TestOld", start, start);
+        for (size_t i = 0; i < Trace::kEventsPerThread; i++) {
+            Trace::Record("TestNew", start, start + microseconds(1));
+        }
+    } };
+    worker.join();
+    Trace::SetEnabled(false);
+
+    std::string json = Trace::ToChromeJson();
+    REQUIRE(CountOccurrences(json, "TestOld") == 0);
+    // the oldest slot is left out as well, since the thread might have been overwriting it
+    REQUIRE(CountOccurrences(json, R"("name":"TestNew")") == Trace::kEventsPerThread - 1);
+    REQUIRE(CountOccurrences(json, R"("dur":1.000)") >= Trace::kEventsPerThread - 1);
+}
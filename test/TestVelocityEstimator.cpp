@@ -0,0 +1,139 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <random>
+
+#include "IVRDevice.hpp"
+#include "PoseMath.hpp"
+#include "VelocityEstimator.hpp"
+
+using namespace SlimeVRDriver;
+using std::chrono::steady_clock;
+
+namespace {
+
+const steady_clock::time_point kStart = steady_clock::time_point(std::chrono::seconds(1000));
+
+steady_clock::time_point At(double seconds) {
+    return kStart + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+// Moving along x at 2m/s and turning around y at 3rad/s
+vr::DriverPose_t PoseAt(double seconds) {
+    vr::DriverPose_t pose = IVRDevice::MakeDefaultPose();
+    pose.vecPosition[0] = 2.0 * seconds;
+    double rotation[3] = { 0.0, 3.0 * seconds, 0.0 };
+    pose.qRotation = QuatFromRotationVector(rotation);
+    return pose;
+}
+
+struct Velocities {
+    double linear[3];
+    double angular[3];
+};
+
+Velocities Estimate(const VelocityEstimator& estimator) {
+    Velocities velocities;
+    REQUIRE(estimator.Estimate(velocities.linear, velocities.angular));
+    return velocities;
+}
+
+} // namespace
+
+TEST_CASE("Constant motion is estimated exactly", "[VelocityEstimator]") {
+    VelocityEstimator estimator;
+    double linear[3];
+    double angular[3];
+    REQUIRE_FALSE(estimator.Estimate(linear, angular));
+    estimator.Push(PoseAt(0.0), At(0.0));
+    REQUIRE_FALSE(estimator.Estimate(linear, angular));
+
+    for (int i = 1; i < 20; i++) {
+        estimator.Push(PoseAt(i * 0.01), At(i * 0.01));
+        auto velocities = Estimate(estimator);
+        REQUIRE(std::abs(velocities.linear[0] - 2.0) < 1e-6);
+        REQUIRE(std::abs(velocities.linear[1]) < 1e-9);
+        REQUIRE(std::abs(velocities.angular[1] - 3.0) < 1e-6);
+        REQUIRE(std::abs(velocities.angular[0]) < 1e-9);
+    }
+}
+
+TEST_CASE("Glitched poses are rejected", "[VelocityEstimator]") {
+    VelocityEstimator estimator;
+    for (int i = 0; i < 5; i++) {
+        estimator.Push(PoseAt(i * 0.005), At(i * 0.005));
+    }
+
+    // one pose jumps 10cm and flips 90 degrees, then tracking recovers
+    auto glitch = PoseAt(0.025);
+    glitch.vecPosition[2] += 0.1;
+    double flip[3] = { 1.5707963, 0.0, 0.0 };
+    glitch.qRotation = QuatMultiply(QuatFromRotationVector(flip), glitch.qRotation);
+    estimator.Push(glitch, At(0.025));
+    auto velocities = Estimate(estimator);
+    REQUIRE(std::abs(velocities.linear[0] - 2.0) < 1e-6);
+    REQUIRE(std::abs(velocities.linear[2]) < 1e-6);
+    REQUIRE(std::abs(velocities.angular[0]) < 1e-6);
+
+    for (int i = 6; i < 8; i++) {
+        estimator.Push(PoseAt(i * 0.005), At(i * 0.005));
+        velocities = Estimate(estimator);
+        REQUIRE(std::abs(velocities.linear[0] - 2.0) < 1e-6);
+        REQUIRE(std::abs(velocities.linear[2]) < 1e-6);
+        REQUIRE(std::abs(velocities.angular[1] - 3.0) < 1e-6);
+    }
+}
+
+TEST_CASE("Irregular arrivals are averaged out", "[VelocityEstimator]") {
+    // 200Hz poses with 1mm of noise, received with jitter and sometimes in bursts
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.001);
+    std::uniform_real_distribution<double> jitter(-0.002, 0.002);
+    std::bernoulli_distribution burst(0.1);
+
+    VelocityEstimator estimator;
+    double estimated_error = 0.0;
+    double naive_error = 0.0;
+    int estimates = 0;
+    double last_x = 0.0;
+    double last_arrival = 0.0;
+    for (int i = 0; i < 2000; i++) {
+        double time = i * 0.005;
+        double arrival = burst(rng) ? last_arrival + 0.0005 : std::max(time + jitter(rng), last_arrival + 0.0005);
+        auto pose = PoseAt(time);
+        pose.vecPosition[0] += noise(rng);
+        estimator.Push(pose, At(arrival));
+
+        if (i > 10) {
+            auto velocities = Estimate(estimator);
+            estimated_error += std::abs(velocities.linear[0] - 2.0);
+            // the velocity between the last two messages
+            naive_error += std::abs((pose.vecPosition[0] - last_x) / (arrival - last_arrival) - 2.0);
+            estimates++;
+        }
+        last_x = pose.vecPosition[0];
+        last_arrival = arrival;
+    }
+
+    // receive times are off by up to 2ms on a 5ms interval, no estimate from receive times is exact
+    REQUIRE(estimated_error / estimates < 0.25);
+    REQUIRE(estimated_error < 0.15 * naive_error);
+}
+
+TEST_CASE("A gap in the stream starts over", "[VelocityEstimator]") {
+    VelocityEstimator estimator;
+    estimator.Push(PoseAt(0.0), At(0.0));
+    estimator.Push(PoseAt(0.01), At(0.01));
+    Estimate(estimator);
+
+    // the tracker stalled and reappeared somewhere else
+    estimator.Push(PoseAt(1.0), At(1.0));
+    double linear[3];
+    double angular[3];
+    REQUIRE_FALSE(estimator.Estimate(linear, angular));
+    REQUIRE(linear[0] == 0.0);
+    REQUIRE(angular[1] == 0.0);
+
+    estimator.Push(PoseAt(1.01), At(1.01));
+    REQUIRE(std::abs(Estimate(estimator).linear[0] - 2.0) < 1e-6);
+}
@@ -0,0 +1,76 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "bridge/BridgeTransport.hpp"
+
+namespace {
+
+/**
+ * Transport without a connection, to feed OnRecv directly.
+ */
+class RecvOnlyTransport : public BridgeTransport {
+public:
+    using BridgeTransport::BridgeTransport;
+    using BridgeTransport::OnRecv;
+
+private:
+    void CreateConnection() override { }
+    void ResetConnection() override { }
+    void CloseConnectionHandles() override { }
+};
+
+messages::ProtobufMessage MakePosition() {
+    messages::ProtobufMessage message;
+    messages::Position* position = message.mutable_position();
+    position->set_tracker_id(3);
+    position->set_x(0.1f);
+    position->set_y(1.2f);
+    position->set_z(-0.3f);
+    position->set_qx(0.1f);
+    position->set_qy(0.7f);
+    position->set_qz(0.1f);
+    position->set_qw(0.7f);
+    position->set_data_source(messages::Position_DataSource_FULL);
+    return message;
+}
+
+} // namespace
+
+TEST_CASE("Bridge framing", "[Bridge]") {
+    auto logger = std::static_pointer_cast<Logger>(std::make_shared<NullLogger>());
+    messages::ProtobufMessage message = MakePosition();
+    std::unique_ptr<char[]> frame;
+    uint32_t frame_size = BridgeTransport::SerializeFrame(message, frame);
+
+    BENCHMARK("SerializeFrame Position") {
+        std::unique_ptr<char[]> buf;
+        return BridgeTransport::SerializeFrame(message, buf);
+    };
+
+    // one read with a single frame, and one with as many frames as the server writes per tick with 16 trackers
+    for (size_t frames : { 1, 16 }) {
+        uint64_t received = 0;
+        RecvOnlyTransport transport(logger, [&](const messages::ProtobufMessage&) { received++; });
+
+        BENCHMARK_ADVANCED("OnRecv Position x" + std::to_string(frames))(Catch::Benchmark::Chronometer meter) {
+            // uvw hands over ownership of the read buffer, prepare them outside the measurement
+            std::vector<uvw::data_event> events;
+            events.reserve(meter.runs());
+            for (int i = 0; i < meter.runs(); i++) {
+                auto data = std::make_unique<char[]>(frame_size * frames);
+                for (size_t f = 0; f < frames; f++) {
+                    std::memcpy(data.get() + f * frame_size, frame.get(), frame_size);
+                }
+                events.emplace_back(std::move(data), frame_size * frames);
+            }
+            meter.measure([&](int i) { transport.OnRecv(events[i]); });
+        };
+
+        REQUIRE(transport.GetStats().TakeSnapshot().resets == 0);
+        REQUIRE(received % frames == 0);
+    }
+}
@@ -0,0 +1,31 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include "bridge/BridgeTransport.hpp"
+#include "bridge/CircularBuffer.hpp"
+
+TEST_CASE("CircularBuffer", "[CircularBuffer]") {
+    // from a length prefix up to the largest frame the bridge accepts
+    for (size_t size : { 4, 64, 256, VRBRIDGE_MAX_MESSAGE_SIZE }) {
+        CircularBuffer buffer(VRBRIDGE_BUFFERS_SIZE);
+        std::vector<char> data(size, 'x');
+        std::vector<char> out(size);
+
+        BENCHMARK("Push/Pop " + std::to_string(size)) {
+            buffer.Push(data.data(), size);
+            return buffer.Pop(out.data(), size);
+        };
+
+        // how OnRecv reads a frame: peek the length, skip it and pop the rest
+        buffer.Push(data.data(), size);
+        BENCHMARK("Peek/Skip/Pop " + std::to_string(size)) {
+            buffer.Push(data.data(), size);
+            buffer.Peek(out.data(), 4);
+            buffer.Skip(4);
+            return buffer.Pop(out.data(), size - 4);
+        };
+    }
+}
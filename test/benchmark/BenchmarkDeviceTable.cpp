@@ -0,0 +1,84 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <format>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "../common/BackgroundLoop.hpp"
+#include "DeviceTable.hpp"
+#include "TrackerDevice.hpp"
+
+using SlimeVRDriver::DeviceTable;
+using SlimeVRDriver::IVRDevice;
+using SlimeVRDriver::TrackerDevice;
+
+namespace {
+
+// The previous device storage in VRDriver, kept here as the benchmark baseline
+class MutexDeviceMap {
+public:
+    void Add(std::shared_ptr<IVRDevice> device) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        devices_.push_back(device);
+        by_id_[device->GetDeviceId()] = device;
+    }
+
+    template <typename F>
+    void WithDevice(int id, F&& fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto device = by_id_.find(id);
+        if (device != by_id_.end())
+            fn(device->second.get());
+    }
+
+    template <typename F>
+    void ForEach(F&& fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& device : devices_)
+            fn(device.get());
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<IVRDevice>> devices_;
+    std::map<int, std::shared_ptr<IVRDevice>> by_id_;
+};
+
+} // namespace
+
+TEST_CASE("Device table", "[DeviceTable]") {
+    for (int trackers : { 5, 20, 60 }) {
+        DeviceTable table;
+        MutexDeviceMap mutex_map;
+        for (int id = 0; id < trackers; id++) {
+            auto device = std::make_shared<TrackerDevice>(std::format("human://{}", id), id, TrackerRole::WAIST);
+            table.Add(device);
+            mutex_map.Add(device);
+        }
+        unsigned int lookups = 0;
+
+        // the background loops stand in for SteamVR's frame thread walking every device in RunFrame
+        {
+            BackgroundLoop frame_thread(1, [&]() { mutex_map.ForEach([](IVRDevice* device) { device->GetDeviceIndex(); }); });
+            BENCHMARK("mutex+map lookup, " + std::to_string(trackers) + " trackers") {
+                IVRDevice* found = nullptr;
+                mutex_map.WithDevice(lookups++ % trackers, [&](IVRDevice* device) { found = device; });
+                return found;
+            };
+        }
+
+        table.Quiesce(DeviceTable::Reader::BRIDGE);
+        {
+            BackgroundLoop frame_thread(1, [&]() {
+                table.Quiesce(DeviceTable::Reader::FRAME);
+                for (auto& device : table.Get().devices)
+                    device->GetDeviceIndex();
+            });
+            BENCHMARK("DeviceTable lookup, " + std::to_string(trackers) + " trackers") {
+                return table.FindById(lookups++ % trackers);
+            };
+        }
+    }
+}
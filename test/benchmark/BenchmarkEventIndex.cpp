@@ -0,0 +1,49 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+#include "EventIndex.hpp"
+
+using SlimeVRDriver::EventIndex;
+
+TEST_CASE("Event dispatch", "[EventIndex]") {
+    for (int devices : { 10, 60 }) {
+        for (int event_count : { 10, 200 }) {
+            std::vector<vr::VREvent_t> events(event_count);
+            for (int i = 0; i < event_count; i++) {
+                if (i % 2) {
+                    events[i].eventType = vr::VREvent_Input_HapticVibration;
+                    events[i].data.hapticVibration.componentHandle = i % devices + 1;
+                } else {
+                    events[i].eventType = vr::VREvent_PropertyChanged;
+                    events[i].trackedDeviceIndex = i % devices;
+                }
+            }
+            auto name = std::to_string(devices) + " devices, " + std::to_string(event_count) + " events";
+
+            // every device scanning every event, as Update used to
+            BENCHMARK("scan, " + name) {
+                int64_t found = 0;
+                for (int device = 0; device < devices; device++) {
+                    for (const auto& event : events) {
+                        if (event.eventType == vr::VREvent_Input_HapticVibration && event.data.hapticVibration.componentHandle == static_cast<uint64_t>(device + 1))
+                            found++;
+                    }
+                }
+                return found;
+            };
+
+            EventIndex index;
+            BENCHMARK("EventIndex, " + name) {
+                int64_t found = 0;
+                index.Build(events);
+                for (int device = 0; device < devices; device++) {
+                    found += index.ForHapticComponent(device + 1).size();
+                }
+                return found;
+            };
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+
+using SlimeVRDriver::LatencyHistogram;
+using namespace std::chrono;
+
+TEST_CASE("Latency histogram", "[LatencyHistogram]") {
+    LatencyHistogram histogram;
+    std::mt19937 rng(1);
+    std::lognormal_distribution<double> latency_us(7.0, 1.0);
+    std::vector<steady_clock::duration> latencies;
+    for (int i = 0; i < 1024; i++) {
+        latencies.push_back(duration_cast<steady_clock::duration>(duration<double, std::micro>(latency_us(rng))));
+    }
+
+    size_t sample = 0;
+    BENCHMARK("Record") {
+        histogram.Record(latencies[sample++ % latencies.size()]);
+    };
+
+    BENCHMARK("ToJson") {
+        return histogram.ToJson();
+    };
+}
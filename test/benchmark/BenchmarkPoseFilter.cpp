@@ -0,0 +1,33 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <vector>
+
+#include "IVRDevice.hpp"
+#include "PoseFilter.hpp"
+
+using namespace SlimeVRDriver;
+
+TEST_CASE("Pose filter", "[PoseFilter]") {
+    PoseFilter filter;
+    filter.Enable({ 1.5, 10.0, 1.0 }, { 1.5, 5.0, 1.0 });
+
+    // noisy poses around the origin, like a tracker standing still
+    std::vector<vr::DriverPose_t> poses(1024, IVRDevice::MakeDefaultPose());
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 0.01);
+    for (auto& pose : poses) {
+        for (double& component : pose.vecPosition)
+            component = noise(rng);
+        double rotation[3] = { noise(rng), noise(rng), noise(rng) };
+        pose.qRotation = QuatFromRotationVector(rotation);
+    }
+
+    size_t sample = 0;
+    BENCHMARK("Filter") {
+        vr::DriverPose_t pose = poses[sample++ % poses.size()];
+        filter.Filter(pose, 0.01);
+        return pose;
+    };
+}
@@ -0,0 +1,35 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "VRDriver.hpp"
+
+using SlimeVRDriver::UniverseTransform;
+using SlimeVRDriver::VRDriver;
+
+TEST_CASE("Pose math", "[PoseMath]") {
+    // 30 degrees of yaw and an offset, like a HMD pose the pose loop reads
+    vr::HmdMatrix34_t matrix = { {
+        { 0.866f, 0.f, 0.5f, 0.2f },
+        { 0.f, 1.f, 0.f, 1.6f },
+        { -0.5f, 0.f, 0.866f, -0.4f },
+    } };
+
+    BENCHMARK("GetRotation") {
+        return VRDriver::GetRotation(matrix);
+    };
+
+    BENCHMARK("GetPosition") {
+        return VRDriver::GetPosition(matrix);
+    };
+
+    auto transform = UniverseTransform::FromTranslation({ { 0.5f, 0.f, -1.f }, 0.7f }, 1);
+    vr::HmdQuaternion_t q = VRDriver::GetRotation(matrix);
+    vr::HmdVector3_t pos = VRDriver::GetPosition(matrix);
+
+    BENCHMARK("UniverseTransform::ToUniverse") {
+        vr::HmdQuaternion_t q_universe = q;
+        vr::HmdVector3_t pos_universe = pos;
+        transform.ToUniverse(q_universe, pos_universe);
+        return pos_universe.v[0] + q_universe.y;
+    };
+}
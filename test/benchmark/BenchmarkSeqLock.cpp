@@ -0,0 +1,76 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../common/BackgroundLoop.hpp"
+#include "IVRDevice.hpp"
+#include "PoseMath.hpp"
+#include "SeqLock.hpp"
+
+using SlimeVRDriver::IVRDevice;
+using SlimeVRDriver::SeqLock;
+using SlimeVRDriver::TimedPose;
+
+namespace {
+
+TimedPose MakeStampedPose(int64_t stamp) {
+    return { IVRDevice::MakeDefaultPose(), std::chrono::steady_clock::time_point(std::chrono::nanoseconds(stamp)) };
+}
+
+// What std::atomic<TimedPose> compiles to: libatomic guards large objects with a lock from a hashed table
+class MutexSlot {
+public:
+    void Store(const TimedPose& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        value_ = value;
+    }
+    TimedPose Load() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return value_;
+    }
+
+private:
+    std::mutex mutex_;
+    TimedPose value_ = MakeStampedPose(0);
+};
+
+/**
+ * Times loads while a writer stores, and stores while `readers` threads load.
+ */
+template <typename Slot>
+void BenchSlot(const std::string& name, Slot& slot, int readers) {
+    // 1kHz is about what a busy server sends, 0 is a writer hammering the slot
+    for (auto interval : { std::chrono::microseconds(1000), std::chrono::microseconds(0) }) {
+        int64_t writes = 0;
+        BackgroundLoop writer(1, [&]() {
+            slot.Store(MakeStampedPose(++writes));
+            if (interval.count())
+                std::this_thread::sleep_for(interval);
+        });
+        BackgroundLoop other_readers(readers - 1, [&]() { slot.Load(); });
+        BENCHMARK(name + " Load, " + std::to_string(readers) + " readers, write every " + std::to_string(interval.count()) + "us") {
+            return slot.Load();
+        };
+    }
+
+    int64_t stamp = 0;
+    BackgroundLoop all_readers(readers, [&]() { slot.Load(); });
+    BENCHMARK(name + " Store, " + std::to_string(readers) + " readers") {
+        slot.Store(MakeStampedPose(++stamp));
+    };
+}
+
+} // namespace
+
+TEST_CASE("Pose slot", "[SeqLock]") {
+    for (int readers : { 1, 2, 4 }) {
+        MutexSlot mutex_slot;
+        SeqLock<TimedPose> seqlock_slot{ MakeStampedPose(0) };
+        BenchSlot("mutex", mutex_slot, readers);
+        BenchSlot("SeqLock", seqlock_slot, readers);
+    }
+}
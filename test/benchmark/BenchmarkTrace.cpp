@@ -0,0 +1,19 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "Trace.hpp"
+
+using SlimeVRDriver::Trace;
+
+TEST_CASE("Trace", "[Trace]") {
+    Trace::SetEnabled(false);
+    BENCHMARK("TRACE_SCOPE disabled") {
+        TRACE_SCOPE("Benchmark");
+    };
+
+    Trace::SetEnabled(true);
+    BENCHMARK("TRACE_SCOPE enabled") {
+        TRACE_SCOPE("Benchmark");
+    };
+    Trace::SetEnabled(false);
+}
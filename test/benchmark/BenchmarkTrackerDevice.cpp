@@ -0,0 +1,39 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "../common/FakeDriverContext.hpp"
+#include "DriverFactory.hpp"
+#include "TrackerDevice.hpp"
+#include "VRDriver.hpp"
+
+TEST_CASE("Tracker device", "[TrackerDevice]") {
+    FakeDriverContext context;
+    REQUIRE(vr::InitServerDriverContext(&context) == vr::VRInitError_None);
+    // not initialised, poses are submitted immediately like with the default settings
+    auto driver = std::make_shared<SlimeVRDriver::VRDriver>();
+    SlimeVRDriver::SetDriver(driver);
+    auto tracker = std::make_shared<SlimeVRDriver::TrackerDevice>("human://WAIST", 3, TrackerRole::WAIST);
+    REQUIRE(driver->AddDevice(tracker));
+    REQUIRE(context.ActivateAddedDevices() == 1);
+
+    messages::Position position;
+    position.set_tracker_id(3);
+    position.set_data_source(messages::Position_DataSource_FULL);
+    position.set_x(0.1f);
+    position.set_y(1.f);
+    position.set_z(0.2f);
+    position.set_qw(1.f);
+    position.set_qx(0.f);
+    position.set_qy(0.f);
+    position.set_qz(0.f);
+    auto received_at = std::chrono::steady_clock::now();
+
+    BENCHMARK("PositionMessage") {
+        // keeps the derived velocity finite
+        received_at += std::chrono::milliseconds(4);
+        tracker->PositionMessage(position, received_at);
+    };
+
+    REQUIRE(context.GetSubmittedPoses(tracker->GetDeviceIndex()).count > 0);
+    SlimeVRDriver::SetDriver(nullptr);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * Calls a function in a loop on background threads until it goes out of scope, to time code while other threads
+ * contend for the same data.
+ */
+class BackgroundLoop {
+public:
+    /**
+     * @param iteration Called concurrently when there is more than one thread.
+     */
+    BackgroundLoop(int threads, std::function<void()> iteration)
+        : iteration_(std::move(iteration)) {
+        for (int i = 0; i < threads; i++) {
+            threads_.emplace_back([this]() {
+                while (!done_) {
+                    iteration_();
+                }
+            });
+        }
+    }
+
+    ~BackgroundLoop() {
+        done_ = true;
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    BackgroundLoop(const BackgroundLoop&) = delete;
+    BackgroundLoop& operator=(const BackgroundLoop&) = delete;
+
+private:
+    std::function<void()> iteration_;
+    std::atomic<bool> done_ = false;
+    std::vector<std::thread> threads_;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "DriverFactory.hpp"
+#include "FakeDriverContext.hpp"
+#include "VRDriver.hpp"
+#include "bridge/BridgeTransport.hpp"
+
+/**
+ * Shuts down a driver running on a FakeDriverContext when it goes out of scope, also when an assertion failed, so its
+ * threads don't outlive the context. Declare it right after a successful Init, after everything the driver's callbacks
+ * use.
+ */
+class DriverGuard {
+public:
+    /**
+     * @param server Stopped once the driver is, before it's destroyed with its thread still running.
+     */
+    DriverGuard(FakeDriverContext& context, SlimeVRDriver::VRDriver& driver, BridgeTransport* server = nullptr)
+        : context_(context)
+        , driver_(driver)
+        , server_(server) { }
+
+    ~DriverGuard() {
+        context_.StopFrames();
+        driver_.Cleanup();
+        if (server_)
+            server_->Stop();
+        SlimeVRDriver::SetDriver(nullptr);
+    }
+
+    DriverGuard(const DriverGuard&) = delete;
+    DriverGuard& operator=(const DriverGuard&) = delete;
+
+private:
+    FakeDriverContext& context_;
+    SlimeVRDriver::VRDriver& driver_;
+    BridgeTransport* server_;
+};
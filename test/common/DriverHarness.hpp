@@ -0,0 +1,122 @@
+#pragma once
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "../BridgeServerMock.hpp"
+#include "DriverFactory.hpp"
+#include "DriverGuard.hpp"
+#include "FakeDriverContext.hpp"
+#include "TrackerRole.hpp"
+#include "VRDriver.hpp"
+
+/**
+ * Polls `condition` every millisecond until it returns true.
+ *
+ * @return false if it didn't within the timeout.
+ */
+template <typename F>
+bool WaitFor(F condition, std::chrono::steady_clock::duration timeout = std::chrono::seconds(5)) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+/**
+ * Sends TrackerAdded with an OK status, like the server does for a new tracker.
+ */
+inline void SendTracker(BridgeServerMock& server, int32_t id, TrackerRole role, const std::string& serial) {
+    messages::ProtobufMessage message;
+    auto* tracker_added = message.mutable_tracker_added();
+    tracker_added->set_tracker_id(id);
+    tracker_added->set_tracker_role(role);
+    tracker_added->set_tracker_serial(serial);
+    tracker_added->set_tracker_name(serial);
+    server.SendBridgeMessage(message);
+
+    auto* tracker_status = message.mutable_tracker_status();
+    tracker_status->set_tracker_id(id);
+    tracker_status->set_status(messages::TrackerStatus_Status_OK);
+    server.SendBridgeMessage(message);
+}
+
+/**
+ * Sends a full position at (x, 1, 0) with no rotation.
+ */
+inline void SendPosition(BridgeServerMock& server, int32_t id, float x) {
+    messages::ProtobufMessage message;
+    auto* position = message.mutable_position();
+    position->set_tracker_id(id);
+    position->set_data_source(messages::Position_DataSource_FULL);
+    position->set_x(x);
+    position->set_y(1.f);
+    position->set_z(0.f);
+    position->set_qw(1.f);
+    position->set_qx(0.f);
+    position->set_qy(0.f);
+    position->set_qz(0.f);
+    server.SendBridgeMessage(message);
+}
+
+/**
+ * A VRDriver on a FakeDriverContext with a headset, connected to a BridgeServerMock.
+ *
+ * The context's settings and pose observer can be changed until `Start()`, which initialises the driver. It is shut
+ * down by `Stop()` or when the harness goes out of scope.
+ */
+class DriverHarness {
+public:
+    /**
+     * @param on_message Called with what the driver sends, on the server's event loop thread.
+     * @param impairment Applied to what the server writes to the driver.
+     */
+    explicit DriverHarness(std::function<void(const messages::ProtobufMessage&)> on_message = [](const messages::ProtobufMessage&) { }, const BridgeServerMock::Impairment& impairment = {})
+        : server(std::make_shared<BridgeServerMock>(std::static_pointer_cast<Logger>(std::make_shared<ConsoleLogger>("ServerMock")), on_message))
+        , driver(std::make_shared<SlimeVRDriver::VRDriver>()) {
+        context.AddHeadset();
+        server->SetImpairment(impairment);
+    }
+
+    /**
+     * Starts the server and initialises the driver, which connects to it. Frames aren't run until `StartFrames()`.
+     */
+    void Start() {
+        server->Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        SlimeVRDriver::SetDriver(driver);
+        REQUIRE(driver->Init(&context) == vr::VRInitError_None);
+        guard_.emplace(context, *driver, server.get());
+    }
+
+    /**
+     * Runs the driver's frames at 90Hz on the context's frame thread.
+     */
+    void StartFrames() {
+        context.StartFrames([this]() { driver->RunFrame(); });
+    }
+
+    /**
+     * Shuts down the driver and the server.
+     */
+    void Stop() {
+        guard_.reset();
+    }
+
+    // declared first, the driver keeps using the context until it's destroyed
+    FakeDriverContext context;
+    std::shared_ptr<BridgeServerMock> server;
+    std::shared_ptr<SlimeVRDriver::VRDriver> driver;
+
+private:
+    std::optional<DriverGuard> guard_;
+};
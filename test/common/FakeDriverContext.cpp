@@ -0,0 +1,627 @@
+#include "FakeDriverContext.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <variant>
+
+#include <simdjson.h>
+
+namespace {
+
+using SettingValue = std::variant<bool, int32_t, float, std::string>;
+
+} // namespace
+
+class FakeDriverContext::ServerDriverHost : public vr::IVRServerDriverHost {
+public:
+    explicit ServerDriverHost(FakeDriverContext& context)
+        : context_(context) { }
+
+    bool TrackedDeviceAdded(const char* pchDeviceSerialNumber, vr::ETrackedDeviceClass eDeviceClass, vr::ITrackedDeviceServerDriver* pDriver) override {
+        vr::TrackedDeviceIndex_t index;
+        {
+            std::lock_guard<std::mutex> lock(context_.mutex_);
+            for (auto& [_, device] : context_.devices_) {
+                if (device.serial == pchDeviceSerialNumber)
+                    return false;
+            }
+            for (index = 0; index < vr::k_unMaxTrackedDeviceCount && context_.devices_.count(index); index++) { }
+            if (index == vr::k_unMaxTrackedDeviceCount)
+                return false;
+            Device& device = context_.devices_[index];
+            device.serial = pchDeviceSerialNumber;
+            device.driver = pDriver;
+            context_.pending_activations_.push_back(index);
+        }
+        context_.SetInt32Property(index, vr::Prop_DeviceClass_Int32, eDeviceClass);
+        context_.SetStringProperty(index, vr::Prop_SerialNumber_String, pchDeviceSerialNumber);
+        context_.SetStringProperty(index, vr::Prop_TrackingSystemName_String, "slimevr");
+        return true;
+    }
+
+    void TrackedDevicePoseUpdated(uint32_t unWhichDevice, const vr::DriverPose_t& newPose, uint32_t unPoseStructSize) override {
+        {
+            std::lock_guard<std::mutex> lock(context_.mutex_);
+            auto it = context_.devices_.find(unWhichDevice);
+            if (it == context_.devices_.end() || !it->second.driver)
+                return;
+            SubmittedPoses& submitted = it->second.submitted;
+            submitted.count++;
+            submitted.last = newPose;
+            submitted.last_at = std::chrono::steady_clock::now();
+        }
+        if (context_.pose_observer_)
+            context_.pose_observer_(unWhichDevice, newPose);
+    }
+
+    void VsyncEvent(double vsyncTimeOffsetSeconds) override { }
+
+    void VendorSpecificEvent(uint32_t unWhichDevice, vr::EVREventType eventType, const vr::VREvent_Data_t& eventData, double eventTimeOffset) override {
+        context_.PushEvent(eventType, unWhichDevice, eventData);
+    }
+
+    bool IsExiting() override {
+        return false;
+    }
+
+    bool PollNextEvent(vr::VREvent_t* pEvent, uint32_t uncbVREvent) override {
+        std::lock_guard<std::mutex> lock(context_.mutex_);
+        if (context_.events_.empty())
+            return false;
+        std::memcpy(pEvent, &context_.events_.front(), std::min<size_t>(uncbVREvent, sizeof(vr::VREvent_t)));
+        context_.events_.pop_front();
+        return true;
+    }
+
+    void GetRawTrackedDevicePoses(float fPredictedSecondsFromNow, vr::TrackedDevicePose_t* pTrackedDevicePoseArray, uint32_t unTrackedDevicePoseArrayCount) override {
+        std::lock_guard<std::mutex> lock(context_.mutex_);
+        uint32_t count = std::min(unTrackedDevicePoseArrayCount, vr::k_unMaxTrackedDeviceCount);
+        std::memcpy(pTrackedDevicePoseArray, context_.poses_, count * sizeof(vr::TrackedDevicePose_t));
+    }
+
+    void RequestRestart(const char* pchLocalizedReason, const char* pchExecutableToStart, const char* pchArguments, const char* pchWorkingDirectory) override { }
+
+    uint32_t GetFrameTimings(vr::Compositor_FrameTiming* pTiming, uint32_t nFrames) override {
+        return 0;
+    }
+
+    void SetDisplayEyeToHead(uint32_t unWhichDevice, const vr::HmdMatrix34_t& eyeToHeadLeft, const vr::HmdMatrix34_t& eyeToHeadRight) override { }
+    void SetDisplayProjectionRaw(uint32_t unWhichDevice, const vr::HmdRect2_t& eyeLeft, const vr::HmdRect2_t& eyeRight) override { }
+    void SetRecommendedRenderTargetSize(uint32_t unWhichDevice, uint32_t nWidth, uint32_t nHeight) override { }
+
+private:
+    FakeDriverContext& context_;
+};
+
+class FakeDriverContext::Properties : public vr::IVRProperties {
+public:
+    explicit Properties(FakeDriverContext& context)
+        : context_(context) { }
+
+    vr::ETrackedPropertyError ReadPropertyBatch(vr::PropertyContainerHandle_t ulContainerHandle, vr::PropertyRead_t* pBatch, uint32_t unBatchEntryCount) override {
+        std::lock_guard<std::mutex> lock(context_.mutex_);
+        auto device = context_.devices_.find(static_cast<vr::TrackedDeviceIndex_t>(ulContainerHandle - 1));
+        for (uint32_t i = 0; i < unBatchEntryCount; i++) {
+            vr::PropertyRead_t& read = pBatch[i];
+            read.unTag = 0;
+            read.unRequiredBufferSize = 0;
+            if (device == context_.devices_.end()) {
+                read.eError = vr::TrackedProp_InvalidDevice;
+                continue;
+            }
+            auto property = device->second.properties.find(read.prop);
+            if (property == device->second.properties.end()) {
+                read.eError = vr::TrackedProp_UnknownProperty;
+                continue;
+            }
+            read.unTag = property->second.tag;
+            read.unRequiredBufferSize = static_cast<uint32_t>(property->second.data.size());
+            if (!read.pvBuffer || read.unBufferSize < property->second.data.size()) {
+                read.eError = vr::TrackedProp_BufferTooSmall;
+                continue;
+            }
+            std::memcpy(read.pvBuffer, property->second.data.data(), property->second.data.size());
+            read.eError = vr::TrackedProp_Success;
+        }
+        return device == context_.devices_.end() ? vr::TrackedProp_InvalidDevice : vr::TrackedProp_Success;
+    }
+
+    vr::ETrackedPropertyError WritePropertyBatch(vr::PropertyContainerHandle_t ulContainerHandle, vr::PropertyWrite_t* pBatch, uint32_t unBatchEntryCount) override {
+        std::lock_guard<std::mutex> lock(context_.mutex_);
+        auto device = context_.devices_.find(static_cast<vr::TrackedDeviceIndex_t>(ulContainerHandle - 1));
+        for (uint32_t i = 0; i < unBatchEntryCount; i++) {
+            vr::PropertyWrite_t& write = pBatch[i];
+            if (device == context_.devices_.end()) {
+                write.eError = vr::TrackedProp_InvalidDevice;
+                continue;
+            }
+            if (write.writeType == vr::PropertyWrite_Set) {
+                auto* data = static_cast<const char*>(write.pvBuffer);
+                device->second.properties[write.prop] = { write.unTag, std::vector<char>(data, data + write.unBufferSize) };
+            } else {
+                device->second.properties.erase(write.prop);
+            }
+            write.eError = vr::TrackedProp_Success;
+        }
+        return device == context_.devices_.end() ? vr::TrackedProp_InvalidDevice : vr::TrackedProp_Success;
+    }
+
+    const char* GetPropErrorNameFromEnum(vr::ETrackedPropertyError error) override {
+        switch (error) {
+        case vr::TrackedProp_Success:
+            return "TrackedProp_Success";
+        case vr::TrackedProp_WrongDataType:
+            return "TrackedProp_WrongDataType";
+        case vr::TrackedProp_BufferTooSmall:
+            return "TrackedProp_BufferTooSmall";
+        case vr::TrackedProp_UnknownProperty:
+            return "TrackedProp_UnknownProperty";
+        case vr::TrackedProp_InvalidDevice:
+            return "TrackedProp_InvalidDevice";
+        default:
+            return "TrackedProp_Unknown";
+        }
+    }
+
+    vr::PropertyContainerHandle_t TrackedDeviceToPropertyContainer(vr::TrackedDeviceIndex_t nDevice) override {
+        return nDevice < vr::k_unMaxTrackedDeviceCount ? nDevice + 1 : vr::k_ulInvalidPropertyContainer;
+    }
+
+private:
+    FakeDriverContext& context_;
+};
+
+class FakeDriverContext::Settings : public vr::IVRSettings {
+public:
+
+    const char* GetSettingsErrorNameFromEnum(vr::EVRSettingsError eError) override {
+        switch (eError) {
+        case vr::VRSettingsError_None:
+            return "VRSettingsError_None";
+        case vr::VRSettingsError_ReadFailed:
+            return "VRSettingsError_ReadFailed";
+        case vr::VRSettingsError_UnsetSettingHasNoDefault:
+            return "VRSettingsError_UnsetSettingHasNoDefault";
+        default:
+            return "VRSettingsError_Unknown";
+        }
+    }
+
+    void SetBool(const char* pchSection, const char* pchSettingsKey, bool bValue, vr::EVRSettingsError* peError = nullptr) override {
+        Set(pchSection, pchSettingsKey, bValue, peError);
+    }
+
+    void SetInt32(const char* pchSection, const char* pchSettingsKey, int32_t nValue, vr::EVRSettingsError* peError = nullptr) override {
+        Set(pchSection, pchSettingsKey, nValue, peError);
+    }
+
+    void SetFloat(const char* pchSection, const char* pchSettingsKey, float flValue, vr::EVRSettingsError* peError = nullptr) override {
+        Set(pchSection, pchSettingsKey, flValue, peError);
+    }
+
+    void SetString(const char* pchSection, const char* pchSettingsKey, const char* pchValue, vr::EVRSettingsError* peError = nullptr) override {
+        Set(pchSection, pchSettingsKey, std::string(pchValue), peError);
+    }
+
+    bool GetBool(const char* pchSection, const char* pchSettingsKey, vr::EVRSettingsError* peError = nullptr) override {
+        return GetNumber<bool>(pchSection, pchSettingsKey, peError);
+    }
+
+    int32_t GetInt32(const char* pchSection, const char* pchSettingsKey, vr::EVRSettingsError* peError = nullptr) override {
+        return GetNumber<int32_t>(pchSection, pchSettingsKey, peError);
+    }
+
+    float GetFloat(const char* pchSection, const char* pchSettingsKey, vr::EVRSettingsError* peError = nullptr) override {
+        return GetNumber<float>(pchSection, pchSettingsKey, peError);
+    }
+
+    void GetString(const char* pchSection, const char* pchSettingsKey, char* pchValue, uint32_t unValueLen, vr::EVRSettingsError* peError = nullptr) override {
+        if (unValueLen)
+            pchValue[0] = '\0';
+        SettingValue value;
+        if (!Find(pchSection, pchSettingsKey, value, peError))
+            return;
+        auto* string = std::get_if<std::string>(&value);
+        if (!string) {
+            if (peError)
+                *peError = vr::VRSettingsError_ReadFailed;
+            return;
+        }
+        if (unValueLen) {
+            size_t length = std::min<size_t>(string->size(), unValueLen - 1);
+            std::memcpy(pchValue, string->data(), length);
+            pchValue[length] = '\0';
+        }
+    }
+
+    void RemoveSection(const char* pchSection, vr::EVRSettingsError* peError = nullptr) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        values_.erase(pchSection);
+        if (peError)
+            *peError = vr::VRSettingsError_None;
+    }
+
+    void RemoveKeyInSection(const char* pchSection, const char* pchSettingsKey, vr::EVRSettingsError* peError = nullptr) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        values_[pchSection].erase(pchSettingsKey);
+        if (peError)
+            *peError = vr::VRSettingsError_None;
+    }
+
+    void Set(const std::string& section, const std::string& key, SettingValue value, vr::EVRSettingsError* peError = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        values_[section][key] = std::move(value);
+        if (peError)
+            *peError = vr::VRSettingsError_None;
+    }
+
+private:
+    bool Find(const char* section, const char* key, SettingValue& value, vr::EVRSettingsError* peError) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto section_it = values_.find(section);
+        if (section_it == values_.end() || !section_it->second.count(key)) {
+            if (peError)
+                *peError = vr::VRSettingsError_UnsetSettingHasNoDefault;
+            return false;
+        }
+        value = section_it->second.at(key);
+        if (peError)
+            *peError = vr::VRSettingsError_None;
+        return true;
+    }
+
+    // numbers and bools convert into each other like in vrserver
+    template <typename T>
+    T GetNumber(const char* section, const char* key, vr::EVRSettingsError* peError) {
+        SettingValue value;
+        if (!Find(section, key, value, peError))
+            return T{};
+        if (std::holds_alternative<std::string>(value)) {
+            if (peError)
+                *peError = vr::VRSettingsError_ReadFailed;
+            return T{};
+        }
+        return std::visit([](auto&& v) -> T {
+            if constexpr (std::is_same_v<std::decay_t<decltype(v)>, std::string>)
+                return T{};
+            else
+                return static_cast<T>(v);
+        },
+                          value);
+    }
+
+    std::mutex mutex_;
+    std::map<std::string, std::map<std::string, SettingValue>> values_;
+};
+
+class FakeDriverContext::DriverInput : public vr::IVRDriverInput {
+public:
+    explicit DriverInput(FakeDriverContext& context)
+        : context_(context) { }
+
+    vr::EVRInputError CreateBooleanComponent(vr::PropertyContainerHandle_t ulContainer, const char* pchName, vr::VRInputComponentHandle_t* pHandle) override {
+        return CreateComponent(ulContainer, pchName, pHandle);
+    }
+
+    vr::EVRInputError UpdateBooleanComponent(vr::VRInputComponentHandle_t ulComponent, bool bNewValue, double fTimeOffset) override {
+        return vr::VRInputError_None;
+    }
+
+    vr::EVRInputError CreateScalarComponent(vr::PropertyContainerHandle_t ulContainer, const char* pchName, vr::VRInputComponentHandle_t* pHandle, vr::EVRScalarType eType, vr::EVRScalarUnits eUnits) override {
+        return CreateComponent(ulContainer, pchName, pHandle);
+    }
+
+    vr::EVRInputError UpdateScalarComponent(vr::VRInputComponentHandle_t ulComponent, float fNewValue, double fTimeOffset) override {
+        return vr::VRInputError_None;
+    }
+
+    vr::EVRInputError CreateHapticComponent(vr::PropertyContainerHandle_t ulContainer, const char* pchName, vr::VRInputComponentHandle_t* pHandle) override {
+        return CreateComponent(ulContainer, pchName, pHandle);
+    }
+
+    vr::EVRInputError CreateSkeletonComponent(vr::PropertyContainerHandle_t ulContainer, const char* pchName, const char* pchSkeletonPath, const char* pchBasePosePath, vr::EVRSkeletalTrackingLevel eSkeletalTrackingLevel, const vr::VRBoneTransform_t* pGripLimitTransforms, uint32_t unGripLimitTransformCount, vr::VRInputComponentHandle_t* pHandle) override {
+        return CreateComponent(ulContainer, pchName, pHandle);
+    }
+
+    vr::EVRInputError UpdateSkeletonComponent(vr::VRInputComponentHandle_t ulComponent, vr::EVRSkeletalMotionRange eMotionRange, const vr::VRBoneTransform_t* pTransforms, uint32_t unTransformCount) override {
+        return vr::VRInputError_None;
+    }
+
+private:
+    vr::EVRInputError CreateComponent(vr::PropertyContainerHandle_t container, const char* name, vr::VRInputComponentHandle_t* handle) {
+        std::lock_guard<std::mutex> lock(context_.mutex_);
+        auto device = context_.devices_.find(static_cast<vr::TrackedDeviceIndex_t>(container - 1));
+        if (device == context_.devices_.end()) {
+            *handle = vr::k_ulInvalidInputComponentHandle;
+            return vr::VRInputError_InvalidHandle;
+        }
+        // far from device indices, so events of tests that use the index as component handle don't match by accident
+        *handle = 0x1000 + next_component_++;
+        device->second.input_components[name] = *handle;
+        return vr::VRInputError_None;
+    }
+
+    FakeDriverContext& context_;
+    vr::VRInputComponentHandle_t next_component_ = 0;
+};
+
+class FakeDriverContext::DriverLog : public vr::IVRDriverLog {
+public:
+    explicit DriverLog(FakeDriverContext& context)
+        : context_(context) { }
+
+    void Log(const char* pchLogMessage) override {
+        if (context_.echo_log_)
+            std::cout << pchLogMessage << std::endl;
+        std::lock_guard<std::mutex> lock(context_.mutex_);
+        context_.log_.emplace_back(pchLogMessage);
+    }
+
+private:
+    FakeDriverContext& context_;
+};
+
+FakeDriverContext::FakeDriverContext()
+    : server_driver_host_(std::make_unique<ServerDriverHost>(*this))
+    , properties_(std::make_unique<Properties>(*this))
+    , settings_interface_(std::make_unique<Settings>())
+    , driver_input_(std::make_unique<DriverInput>(*this))
+    , driver_log_(std::make_unique<DriverLog>(*this))
+    , property_helpers_(properties_.get()) {
+    LoadDefaultSettings();
+}
+
+FakeDriverContext::~FakeDriverContext() {
+    StopFrames();
+}
+
+void* FakeDriverContext::GetGenericInterface(const char* pchInterfaceVersion, vr::EVRInitError* peError) {
+    void* result = nullptr;
+    if (std::strcmp(pchInterfaceVersion, vr::IVRServerDriverHost_Version) == 0) {
+        result = server_driver_host_.get();
+    } else if (std::strcmp(pchInterfaceVersion, vr::IVRProperties_Version) == 0) {
+        result = properties_.get();
+    } else if (std::strcmp(pchInterfaceVersion, vr::IVRSettings_Version) == 0) {
+        result = settings_interface_.get();
+    } else if (std::strcmp(pchInterfaceVersion, vr::IVRDriverInput_Version) == 0) {
+        result = driver_input_.get();
+    } else if (std::strcmp(pchInterfaceVersion, vr::IVRDriverLog_Version) == 0) {
+        result = driver_log_.get();
+    }
+    if (peError)
+        *peError = result ? vr::VRInitError_None : vr::VRInitError_Init_InterfaceNotFound;
+    return result;
+}
+
+vr::DriverHandle_t FakeDriverContext::GetDriverHandle() {
+    return 1;
+}
+
+void FakeDriverContext::AddDevice(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceClass device_class, const std::string& serial, const std::string& tracking_system) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        devices_[index].serial = serial;
+    }
+    SetInt32Property(index, vr::Prop_DeviceClass_Int32, device_class);
+    SetStringProperty(index, vr::Prop_SerialNumber_String, serial);
+    SetStringProperty(index, vr::Prop_TrackingSystemName_String, tracking_system);
+    SetStringProperty(index, vr::Prop_ModelNumber_String, serial + " model");
+    SetStringProperty(index, vr::Prop_ManufacturerName_String, tracking_system);
+}
+
+void FakeDriverContext::AddHeadset() {
+    AddDevice(vr::k_unTrackedDeviceIndex_Hmd, vr::TrackedDeviceClass_HMD, "HMD");
+    AddDevice(1, vr::TrackedDeviceClass_Controller, "Left controller");
+    SetInt32Property(1, vr::Prop_ControllerRoleHint_Int32, vr::TrackedControllerRole_LeftHand);
+    AddDevice(2, vr::TrackedDeviceClass_Controller, "Right controller");
+    SetInt32Property(2, vr::Prop_ControllerRoleHint_Int32, vr::TrackedControllerRole_RightHand);
+    const vr::HmdQuaternion_t identity{ 1, 0, 0, 0 };
+    SetPose(vr::k_unTrackedDeviceIndex_Hmd, { 0.f, 1.7f, 0.f }, identity);
+    SetPose(1, { -0.3f, 1.f, 0.2f }, identity);
+    SetPose(2, { 0.3f, 1.f, 0.2f }, identity);
+    for (vr::TrackedDeviceIndex_t index = 0; index < 3; index++) {
+        PushEvent(vr::VREvent_TrackedDeviceActivated, index);
+    }
+}
+
+void FakeDriverContext::SetPose(vr::TrackedDeviceIndex_t index, const vr::HmdVector3_t& position, const vr::HmdQuaternion_t& rotation) {
+    vr::TrackedDevicePose_t pose{};
+    const auto& q = rotation;
+    float(&m)[3][4] = pose.mDeviceToAbsoluteTracking.m;
+    m[0][0] = static_cast<float>(1 - 2 * (q.y * q.y + q.z * q.z));
+    m[0][1] = static_cast<float>(2 * (q.x * q.y - q.z * q.w));
+    m[0][2] = static_cast<float>(2 * (q.x * q.z + q.y * q.w));
+    m[1][0] = static_cast<float>(2 * (q.x * q.y + q.z * q.w));
+    m[1][1] = static_cast<float>(1 - 2 * (q.x * q.x + q.z * q.z));
+    m[1][2] = static_cast<float>(2 * (q.y * q.z - q.x * q.w));
+    m[2][0] = static_cast<float>(2 * (q.x * q.z - q.y * q.w));
+    m[2][1] = static_cast<float>(2 * (q.y * q.z + q.x * q.w));
+    m[2][2] = static_cast<float>(1 - 2 * (q.x * q.x + q.y * q.y));
+    for (int i = 0; i < 3; i++) {
+        m[i][3] = position.v[i];
+    }
+    pose.eTrackingResult = vr::TrackingResult_Running_OK;
+    pose.bPoseIsValid = true;
+    pose.bDeviceIsConnected = true;
+    SetPose(index, pose);
+}
+
+void FakeDriverContext::SetPose(vr::TrackedDeviceIndex_t index, const vr::TrackedDevicePose_t& pose) {
+    if (index >= vr::k_unMaxTrackedDeviceCount)
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    poses_[index] = pose;
+}
+
+void FakeDriverContext::SetUniverse(uint64_t universe_id, const vr::HmdVector3_t& translation, float yaw) {
+    SetStringProperty(
+        vr::k_unTrackedDeviceIndex_Hmd,
+        vr::Prop_DriverProvidedChaperoneJson_String,
+        std::format(
+            R"({{"universes":[{{"universeID":"{}","standing":{{"translation":[{},{},{}],"yaw":{}}}}}]}})",
+            universe_id, translation.v[0], translation.v[1], translation.v[2], yaw));
+    SetUint64Property(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_CurrentUniverseId_Uint64, universe_id);
+}
+
+void FakeDriverContext::PushEvent(vr::EVREventType type, vr::TrackedDeviceIndex_t index, const vr::VREvent_Data_t& data) {
+    vr::VREvent_t event{};
+    event.eventType = type;
+    event.trackedDeviceIndex = index;
+    event.data = data;
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back(event);
+}
+
+void FakeDriverContext::SetBoolProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, bool value) {
+    SetProperty(index, prop, vr::k_unBoolPropertyTag, &value, sizeof(value));
+}
+
+void FakeDriverContext::SetInt32Property(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, int32_t value) {
+    SetProperty(index, prop, vr::k_unInt32PropertyTag, &value, sizeof(value));
+}
+
+void FakeDriverContext::SetUint64Property(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, uint64_t value) {
+    SetProperty(index, prop, vr::k_unUint64PropertyTag, &value, sizeof(value));
+}
+
+void FakeDriverContext::SetFloatProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, float value) {
+    SetProperty(index, prop, vr::k_unFloatPropertyTag, &value, sizeof(value));
+}
+
+void FakeDriverContext::SetStringProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, const std::string& value) {
+    SetProperty(index, prop, vr::k_unStringPropertyTag, value.c_str(), value.size() + 1);
+}
+
+void FakeDriverContext::SetProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t tag, const void* value, size_t size) {
+    auto* data = static_cast<const char*>(value);
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices_[index].properties[prop] = { tag, std::vector<char>(data, data + size) };
+}
+
+vr::IVRSettings& FakeDriverContext::GetSettings() {
+    return *settings_interface_;
+}
+
+size_t FakeDriverContext::ActivateAddedDevices() {
+    std::vector<std::pair<vr::TrackedDeviceIndex_t, vr::ITrackedDeviceServerDriver*>> activations;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto index : pending_activations_) {
+            activations.emplace_back(index, devices_[index].driver);
+        }
+        pending_activations_.clear();
+    }
+    for (auto [index, driver] : activations) {
+        driver->Activate(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            devices_[index].activated = true;
+        }
+        PushEvent(vr::VREvent_TrackedDeviceActivated, index);
+    }
+    return activations.size();
+}
+
+void FakeDriverContext::StartFrames(std::function<void()> run_frame) {
+    if (frame_thread_)
+        return;
+    running_frames_ = true;
+    frame_thread_ = std::make_unique<std::thread>([this, run_frame]() {
+        while (running_frames_) {
+            ActivateAddedDevices();
+            run_frame();
+            std::this_thread::sleep_for(std::chrono::microseconds(11111));
+        }
+    });
+}
+
+void FakeDriverContext::StopFrames() {
+    if (!frame_thread_)
+        return;
+    running_frames_ = false;
+    frame_thread_->join();
+    frame_thread_.reset();
+}
+
+vr::TrackedDeviceIndex_t FakeDriverContext::FindDriverDevice(const std::string& serial) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& [index, device] : devices_) {
+        if (device.driver && device.serial == serial)
+            return index;
+    }
+    return vr::k_unTrackedDeviceIndexInvalid;
+}
+
+size_t FakeDriverContext::CountActivatedDevices() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto& [_, device] : devices_) {
+        if (device.activated)
+            count++;
+    }
+    return count;
+}
+
+bool FakeDriverContext::IsActivated(vr::TrackedDeviceIndex_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = devices_.find(index);
+    return it != devices_.end() && it->second.activated;
+}
+
+FakeDriverContext::SubmittedPoses FakeDriverContext::GetSubmittedPoses(vr::TrackedDeviceIndex_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = devices_.find(index);
+    return it != devices_.end() ? it->second.submitted : SubmittedPoses{};
+}
+
+vr::VRInputComponentHandle_t FakeDriverContext::FindInputComponent(vr::TrackedDeviceIndex_t index, const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto device = devices_.find(index);
+    if (device == devices_.end())
+        return vr::k_ulInvalidInputComponentHandle;
+    auto component = device->second.input_components.find(name);
+    return component != device->second.input_components.end() ? component->second : vr::k_ulInvalidInputComponentHandle;
+}
+
+bool FakeDriverContext::HasLogged(const std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& message : log_) {
+        if (message.find(text) != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+void FakeDriverContext::LoadDefaultSettings() {
+    // the same defaults vrserver loads from the driver resources
+    auto json = simdjson::padded_string::load(SLIMEVR_DRIVER_DIR "/resources/settings/default.vrsettings");
+    if (json.error())
+        throw std::runtime_error("default.vrsettings not found in " SLIMEVR_DRIVER_DIR);
+    simdjson::ondemand::parser parser;
+    simdjson::ondemand::document doc = parser.iterate(json.value_unsafe());
+    for (auto section : doc.get_object()) {
+        std::string section_name{ section.unescaped_key().value() };
+        for (auto setting : section.value().get_object()) {
+            std::string key{ setting.unescaped_key().value() };
+            simdjson::ondemand::value value = setting.value();
+            switch (value.type().value()) {
+            case simdjson::ondemand::json_type::boolean:
+                settings_interface_->Set(section_name, key, bool(value.get_bool()));
+                break;
+            case simdjson::ondemand::json_type::number:
+                if (value.is_integer())
+                    settings_interface_->Set(section_name, key, static_cast<int32_t>(int64_t(value.get_int64())));
+                else
+                    settings_interface_->Set(section_name, key, static_cast<float>(double(value.get_double())));
+                break;
+            case simdjson::ondemand::json_type::string:
+                settings_interface_->Set(section_name, key, std::string(std::string_view(value.get_string())));
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
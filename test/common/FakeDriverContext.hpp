@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <openvr_driver.h>
+
+/**
+ * In-process stand-in for SteamVR, to run VRDriver and TrackerDevice outside of vrserver.
+ *
+ * Passed to VRDriver::Init, or to vr::InitServerDriverContext for devices on their own. It serves IVRServerDriverHost,
+ * IVRProperties, IVRSettings, IVRDriverInput and IVRDriverLog from GetGenericInterface. The devices of other drivers, their properties
+ * and raw poses, the current universe and the events returned from PollNextEvent are set up by the test and can be
+ * changed while the driver runs, from any thread. Settings start out as the defaults in default.vrsettings.
+ *
+ * Input components are created with unique handles but their values aren't recorded.
+ */
+class FakeDriverContext : public vr::IVRDriverContext {
+public:
+    // poses the driver submitted for one of its devices
+    struct SubmittedPoses {
+        uint64_t count = 0;
+        vr::DriverPose_t last{};
+        std::chrono::steady_clock::time_point last_at{};
+    };
+
+    FakeDriverContext();
+    ~FakeDriverContext();
+
+    FakeDriverContext(const FakeDriverContext&) = delete;
+    FakeDriverContext& operator=(const FakeDriverContext&) = delete;
+
+    void* GetGenericInterface(const char* pchInterfaceVersion, vr::EVRInitError* peError = nullptr) override;
+    vr::DriverHandle_t GetDriverHandle() override;
+
+    /**
+     * Adds a device of another driver, like the HMD or a controller, with the properties the pose request thread reads.
+     *
+     * @param tracking_system Prop_TrackingSystemName_String, devices of "slimevr" are ignored by the driver.
+     */
+    void AddDevice(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceClass device_class, const std::string& serial, const std::string& tracking_system = "lighthouse");
+
+    /**
+     * Adds an HMD at index 0 and a left and right controller at 1 and 2, standing at the origin, and queues their
+     * activation events like SteamVR does before it runs the first frame.
+     */
+    void AddHeadset();
+
+    /**
+     * Sets the raw pose GetRawTrackedDevicePoses returns for a device, connected and running OK.
+     */
+    void SetPose(vr::TrackedDeviceIndex_t index, const vr::HmdVector3_t& position, const vr::HmdQuaternion_t& rotation);
+    void SetPose(vr::TrackedDeviceIndex_t index, const vr::TrackedDevicePose_t& pose);
+
+    /**
+     * Makes a universe current on the HMD, provided as driver chaperone JSON like a lighthouse-less HMD would.
+     */
+    void SetUniverse(uint64_t universe_id, const vr::HmdVector3_t& translation, float yaw);
+
+    /**
+     * Queues an event for PollNextEvent.
+     */
+    void PushEvent(vr::EVREventType type, vr::TrackedDeviceIndex_t index, const vr::VREvent_Data_t& data = {});
+
+    void SetBoolProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, bool value);
+    void SetInt32Property(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, int32_t value);
+    void SetUint64Property(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, uint64_t value);
+    void SetFloatProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, float value);
+    void SetStringProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, const std::string& value);
+
+    /**
+     * Property helpers reading and writing the properties of this context, like vr::VRProperties().
+     */
+    vr::CVRPropertyHelpers& GetProperties() {
+        return property_helpers_;
+    }
+
+    vr::IVRSettings& GetSettings();
+
+    /**
+     * Activates the devices the driver added since the last call and queues a TrackedDeviceActivated event for each.
+     * SteamVR does this on its own thread after TrackedDeviceAdded returned.
+     *
+     * @return The number of devices activated.
+     */
+    size_t ActivateAddedDevices();
+
+    /**
+     * Calls `run_frame` at 90Hz on a thread, like vrserver's main loop calls RunFrame of the driver, activating the
+     * devices it added first.
+     */
+    void StartFrames(std::function<void()> run_frame);
+    void StopFrames();
+
+    /**
+     * Returns the index SteamVR gave a device of the driver, k_unTrackedDeviceIndexInvalid if it wasn't added.
+     */
+    vr::TrackedDeviceIndex_t FindDriverDevice(const std::string& serial);
+
+    /**
+     * Returns the number of devices of the driver that were activated.
+     */
+    size_t CountActivatedDevices();
+
+    /**
+     * Returns true once a device of the driver was activated.
+     */
+    bool IsActivated(vr::TrackedDeviceIndex_t index);
+
+    SubmittedPoses GetSubmittedPoses(vr::TrackedDeviceIndex_t index);
+
+    /**
+     * Returns the handle of an input component a device created, like "/output/haptic", k_ulInvalidInputComponentHandle
+     * if it has none by that name.
+     */
+    vr::VRInputComponentHandle_t FindInputComponent(vr::TrackedDeviceIndex_t index, const std::string& name);
+
+    /**
+     * Called for every pose the driver submits, on the thread that submitted it. Set before the driver starts.
+     */
+    void SetPoseObserver(std::function<void(vr::TrackedDeviceIndex_t, const vr::DriverPose_t&)> observer) {
+        pose_observer_ = observer;
+    }
+
+    /**
+     * Returns true once a message containing `text` was written to the driver log.
+     */
+    bool HasLogged(const std::string& text);
+
+    /**
+     * Prints driver log messages to stdout as they are written, off by default.
+     */
+    void SetEchoLog(bool echo) {
+        echo_log_ = echo;
+    }
+
+private:
+    struct Property {
+        vr::PropertyTypeTag_t tag;
+        std::vector<char> data;
+    };
+
+    struct Device {
+        std::string serial;
+        std::map<vr::ETrackedDeviceProperty, Property> properties;
+        // set for devices of the driver under test
+        vr::ITrackedDeviceServerDriver* driver = nullptr;
+        bool activated = false;
+        SubmittedPoses submitted;
+        std::map<std::string, vr::VRInputComponentHandle_t> input_components;
+    };
+
+    class ServerDriverHost;
+    class Properties;
+    class Settings;
+    class DriverInput;
+    class DriverLog;
+
+    void SetProperty(vr::TrackedDeviceIndex_t index, vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t tag, const void* value, size_t size);
+    void LoadDefaultSettings();
+
+    std::mutex mutex_;
+    std::map<vr::TrackedDeviceIndex_t, Device> devices_;
+    vr::TrackedDevicePose_t poses_[vr::k_unMaxTrackedDeviceCount]{};
+    std::deque<vr::VREvent_t> events_;
+    std::vector<vr::TrackedDeviceIndex_t> pending_activations_;
+    std::vector<std::string> log_;
+    std::atomic<bool> echo_log_ = false;
+    std::function<void(vr::TrackedDeviceIndex_t, const vr::DriverPose_t&)> pose_observer_;
+    std::atomic<bool> running_frames_ = false;
+    std::unique_ptr<std::thread> frame_thread_;
+
+    std::unique_ptr<ServerDriverHost> server_driver_host_;
+    std::unique_ptr<Properties> properties_;
+    std::unique_ptr<Settings> settings_interface_;
+    std::unique_ptr<DriverInput> driver_input_;
+    std::unique_ptr<DriverLog> driver_log_;
+    vr::CVRPropertyHelpers property_helpers_;
+};
@@ -38,8 +38,8 @@ void TestBridgeClient() {
 
     std::atomic<bool> ready_to_bench = false;
     std::atomic<steady_clock::time_point> position_requested_at = steady_clock::now();
-    std::map<int, double> latency_nanos_sum;
-    std::map<int, int> latency_nanos_count;
+    std::map<int, SlimeVRDriver::LatencyHistogram> latency;
+    SlimeVRDriver::LatencyHistogram round_trip;
 
     int invalid_messages = 0;
     int trackers = 0;
@@ -68,10 +68,10 @@ void TestBridgeClient() {
                 if (!ready_to_bench)
                     return;
 
-                auto id = pos.tracker_id();
-                auto dt = duration_cast<nanoseconds>(steady_clock::now() - position_requested_at.load());
-                latency_nanos_count[id]++;
-                latency_nanos_sum[id] += dt.count();
+                latency[pos.tracker_id()].Record(steady_clock::now() - position_requested_at.load());
+            } else if (message.has_ping_pong()) {
+                steady_clock::time_point sent_at{ microseconds(message.ping_pong().sent_at_us()) };
+                round_trip.Record(steady_clock::now() - sent_at);
             } else {
                 invalid_messages++;
             }
@@ -129,16 +129,21 @@ void TestBridgeClient() {
 
         position_requested_at = steady_clock::now();
         bridge->SendBridgeMessage(*message);
+
+        messages::PingPong* ping = google::protobuf::Arena::Create<messages::PingPong>(&arena);
+        message->set_allocated_ping_pong(ping);
+        ping->set_sent_at_us(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+        bridge->SendBridgeMessage(*message);
         std::this_thread::sleep_for(milliseconds(10));
     }
 
     bridge->Stop();
 
-    for (const auto& [id, sum] : latency_nanos_sum) {
-        auto avg_latency_nanos = static_cast<int>(latency_nanos_count[id] ? sum / latency_nanos_count[id] : -1);
-        auto avg_latency_ms = duration_cast<duration<double, std::milli>>(nanoseconds(avg_latency_nanos));
-        logger->Log("avg latency for tracker {}: {:.3f}ms", id, avg_latency_ms.count());
+    for (const auto& [id, histogram] : latency) {
+        logger->Log("latency for tracker {}: {}", id, histogram.ToJson());
     }
+    // servers before protocol version 3 don't answer pings
+    logger->Log("round trip: {}", round_trip.ToJson());
 
     if (invalid_messages)
         FAIL("Invalid messages received");